@@ -0,0 +1,346 @@
+/**
+*	@file Batch.cpp
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class implementation for Monte Carlo batch runs of the simulator.
+*	@date Monday, April 30, 2018
+*/
+
+//
+// Header Files ///////////////////////////
+//
+#include "Batch.h"
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <unistd.h>
+#include <sys/wait.h>
+
+//
+// Class Function Definitions /////////////////
+//
+
+/**	Constructor
+*	\n Creates a batch repeating each variant of a configuration file a number of times.
+*	@param configFile is the path of the configuration file
+*	@param runCount is the number of runs of each variant (at least 1)
+*/
+Batch::Batch(std::string configFile, unsigned int runCount) : configFilename(configFile) {
+	runs = (runCount > 0 ? runCount : 1);
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	jobs = (cores > 0 ? cores : 1);
+	seedGiven = false;
+	firstSeed = 0;
+}
+
+/**	Set Jobs
+*	\n Sets the number of runs simulated at once; by default, one per core.
+*	@param count is the number of runs at once (at least 1)
+*/
+void Batch::SetJobs(unsigned int count) {
+	jobs = (count > 0 ? count : 1);
+}
+
+/**	Set First Seed
+*	\n Sets the seed of each variant's first run; the runs after it take the following seeds. By default the runs
+*	start from the configured "Random Seed".
+*	@param seed is the seed of the first run
+*/
+void Batch::SetFirstSeed(uint64_t seed) {
+	firstSeed = seed;
+	seedGiven = true;
+}
+
+/**	Add Override
+*	\n Adds a configuration line, e.g. "Processor quantity: 4", which takes the place of the file's in every run.
+*	@param line is the configuration line
+*/
+void Batch::AddOverride(const std::string &line) {
+	overrides.push_back(line);
+}
+
+/**	Add Variation
+*	\n Adds a key whose values are varied, given as "Key: value|value|...". Every combination of the varied values is
+*	a variant, and each variant is run with the same seeds, so the variants are compared on the same random draws.
+*	@param line is the key and its values
+*	@throw the line names no key or no value
+*/
+void Batch::AddVariation(const std::string &line) throw(std::logic_error) {
+	std::string::size_type colon = line.find(':');
+	std::string key = (colon == std::string::npos ? "" : line.substr(0, colon));
+	key.erase(key.find_last_not_of(" \t") + 1);
+
+	std::vector<std::string> values;
+	std::string::size_type pos = colon;
+	while (pos != std::string::npos) {
+		std::string::size_type next = line.find('|', pos + 1);
+		std::string value = line.substr(pos + 1, next == std::string::npos ? std::string::npos : next - pos - 1);
+		value.erase(0, value.find_first_not_of(" \t"));
+		value.erase(value.find_last_not_of(" \t") + 1);
+		if (value.empty()) {
+			throw std::logic_error("Batch variations are given as \"Key: value|value|...\"; check command line parameter.");
+		}
+		values.push_back(value);
+		pos = next;
+	}
+	if (key.empty() || values.empty()) {
+		throw std::logic_error("Batch variations are given as \"Key: value|value|...\"; check command line parameter.");
+	}
+	variations.push_back(std::make_pair(key, values));
+}
+
+/**	Run
+*	\n Loads the workload once, then runs every variant the given number of times, up to the given number of runs at
+*	once, and reports a summary of each variant. A run which fails, e.g. on a deadlock, is counted and left out of
+*	the summary. Runs are always in virtual time, and keep no log.
+*	@throw a variant's configuration is invalid, the workload cannot be loaded, or a run cannot be started
+*/
+void Batch::Run() throw(std::logic_error) {
+	BuildVariants();
+
+	// The forked runs share the loaded processes, which the meta-data named by the first variant describes
+	conf = variants[0].config;
+	OperatingSystem os;
+
+	outcomes.assign(variants.size(), std::vector<Outcome>(runs));
+	std::cout.flush();
+	std::vector<Job> running;
+	for (unsigned int v = 0; v < variants.size(); v++) {
+		for (unsigned int r = 0; r < runs; r++) {
+			while (running.size() >= jobs) {
+				Collect(running);
+			}
+
+			int ends[2];
+			if (pipe(ends) != 0) {
+				throw std::logic_error("Batch run could not be started: " + std::string(strerror(errno)));
+			}
+			pid_t pid = fork();
+			if (pid < 0) {
+				close(ends[0]);
+				close(ends[1]);
+				throw std::logic_error("Batch run could not be started: " + std::string(strerror(errno)));
+			}
+			if (pid == 0) {
+				close(ends[0]);
+				RunJob(os, v, Seed(v, r), ends[1]);
+			}
+			close(ends[1]);
+			running.push_back(Job(pid, ends[0], v, r));
+		}
+	}
+	while (!running.empty()) {
+		Collect(running);
+	}
+
+	Report();
+}
+
+/**	Build Variants
+*	\n Reads the configuration once for every combination of the varied values, so that a bad value is reported
+*	before any run starts. Every variant runs in virtual time, without a log or reloading.
+*	@throw a variant's configuration is invalid, or a variant names other meta-data
+*/
+void Batch::BuildVariants() throw(std::logic_error) {
+	unsigned int count = 1;
+	for (unsigned int i = 0; i < variations.size(); i++) {
+		count *= variations[i].second.size();
+	}
+
+	std::vector<char> path(configFilename.begin(), configFilename.end());
+	path.push_back('\0');
+
+	variants.clear();
+	for (unsigned int index = 0; index < count; index++) {
+		// The index counts through the combinations, the last key varying fastest
+		Variant variant;
+		unsigned int digits = index;
+		for (unsigned int i = variations.size(); i-- > 0; ) {
+			const std::vector<std::string> &values = variations[i].second;
+			std::string line = variations[i].first + ": " + values[digits % values.size()];
+			variant.lines.insert(variant.lines.begin(), line);
+			digits /= values.size();
+		}
+		for (unsigned int i = 0; i < variant.lines.size(); i++) {
+			variant.label += (i == 0 ? "" : "; ") + variant.lines[i];
+		}
+		if (variant.label.empty()) {
+			variant.label = configFilename;
+		}
+		variant.lines.insert(variant.lines.end(), overrides.begin(), overrides.end());
+
+		variant.config.ConfigInit(&path[0], variant.lines);
+		variant.config.simulationMode = "VIRTUAL";
+		variant.config.configReload = "OFF";
+		variant.config.logSetting = "None";
+		if (!variants.empty() && variant.config.metaDataFilename != variants[0].config.metaDataFilename) {
+			throw std::logic_error("Batch variants must share one meta-data file; check command line parameter.");
+		}
+		variants.push_back(variant);
+	}
+}
+
+/**	Run Job
+*	\n Runs one simulation in a forked copy of the batch, and writes its outcome to the pipe. Never returns.
+*	@param os is the operating system with the workload loaded, not yet run
+*	@param variant is the index of the variant to run
+*	@param seed is the seed of the run
+*	@param pipe is the write end of the pipe to the batch
+*/
+void Batch::RunJob(OperatingSystem &os, unsigned int variant, uint64_t seed, int pipe) {
+	Outcome outcome;
+	memset(&outcome, 0, sizeof(outcome));
+
+	try {
+		conf = variants[variant].config;
+		conf.randomSeed = seed;
+		os.reconfigure();
+		os.runSimulation();
+
+		Executor::Metrics metrics = os.getRunMetrics();
+		outcome.completed = 1;
+		outcome.makespan = metrics.makespan / 1000;
+		outcome.turnaround = metrics.meanTurnaround / 1000;
+		outcome.utilization = metrics.utilization * 100;
+	}
+	catch (std::exception &error) {
+		strncpy(outcome.error, error.what(), sizeof(outcome.error) - 1);
+	}
+
+	// The outcome is smaller than PIPE_BUF, so it is written whole
+	ssize_t written = write(pipe, &outcome, sizeof(outcome));
+	(void)written;
+	close(pipe);
+	_exit(0);
+}
+
+/**	Collect
+*	\n Waits for a running job to end, and reads its outcome. A run which ended without writing one, e.g. on a
+*	crash, counts as failed.
+*	@param running are the jobs running; the ended job is removed
+*	@throw no job could be waited for
+*/
+void Batch::Collect(std::vector<Job> &running) throw(std::logic_error) {
+	int status;
+	pid_t pid;
+	do {
+		pid = waitpid(-1, &status, 0);
+	} while (pid < 0 && errno == EINTR);
+	if (pid < 0) {
+		throw std::logic_error("Batch run could not be waited for: " + std::string(strerror(errno)));
+	}
+
+	for (unsigned int i = 0; i < running.size(); i++) {
+		if (running[i].pid != pid) {
+			continue;
+		}
+
+		Outcome &outcome = outcomes[running[i].variant][running[i].run];
+		ssize_t length;
+		do {
+			length = read(running[i].pipe, &outcome, sizeof(outcome));
+		} while (length < 0 && errno == EINTR);
+		if (length != (ssize_t)sizeof(outcome)) {
+			memset(&outcome, 0, sizeof(outcome));
+			strncpy(outcome.error, "run ended abnormally", sizeof(outcome.error) - 1);
+		}
+		close(running[i].pipe);
+		running.erase(running.begin() + i);
+		return;
+	}
+}
+
+/**	Seed
+*	\n Getter function for the seed of a run. The runs of a variant take consecutive seeds from its first.
+*	@param variant is the index of the variant
+*	@param run is the index of the run within the variant
+*	@return the seed of the run
+*/
+uint64_t Batch::Seed(unsigned int variant, unsigned int run) const {
+	return (seedGiven ? firstSeed : variants[variant].config.randomSeed) + run;
+}
+
+/**	Report
+*	\n Writes the summary of every variant to standard output: the number of runs completed, and the mean, standard
+*	deviation and 95% confidence interval of each metric over the completed runs.
+*/
+void Batch::Report() const {
+	std::cout << "Batch: " << variants.size() << " variant" << (variants.size() == 1 ? "" : "s") << " x " << runs
+		<< " run" << (runs == 1 ? "" : "s") << ", seeds " << Seed(0, 0) << " to " << Seed(0, runs - 1)
+		<< ", " << jobs << " at once, virtual time" << std::endl;
+
+	for (unsigned int v = 0; v < variants.size(); v++) {
+		std::vector<double> makespans, turnarounds, utilizations;
+		std::string firstError;
+		for (unsigned int r = 0; r < runs; r++) {
+			const Outcome &outcome = outcomes[v][r];
+			if (outcome.completed) {
+				makespans.push_back(outcome.makespan);
+				turnarounds.push_back(outcome.turnaround);
+				utilizations.push_back(outcome.utilization);
+			}
+			else if (firstError.empty()) {
+				firstError = "seed " + std::to_string(Seed(v, r)) + ": " + outcome.error;
+			}
+		}
+
+		std::cout << std::endl << "Variant " << v + 1 << ": " << variants[v].label << std::endl;
+		std::cout << "\tcompleted runs " << makespans.size() << " of " << runs << std::endl;
+		if (!firstError.empty()) {
+			std::cout << "\tfirst failure, " << firstError << std::endl;
+		}
+		Summarize("makespan (ms)", makespans);
+		Summarize("mean turnaround (ms)", turnarounds);
+		Summarize("CPU utilization (%)", utilizations);
+	}
+}
+
+/**	Summarize
+*	\n Writes the mean, standard deviation and 95% confidence interval of the mean of a metric.
+*	@param name is the metric and its unit
+*	@param values are the metric's value in each completed run
+*/
+void Batch::Summarize(std::string name, const std::vector<double> &values) {
+	if (values.empty()) {
+		return;
+	}
+
+	double mean = 0;
+	for (unsigned int i = 0; i < values.size(); i++) {
+		mean += values[i];
+	}
+	mean /= values.size();
+
+	std::cout << "\t" << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(3)
+		<< "mean " << std::setw(12) << mean;
+	if (values.size() > 1) {
+		double squares = 0;
+		for (unsigned int i = 0; i < values.size(); i++) {
+			squares += (values[i] - mean) * (values[i] - mean);
+		}
+		double deviation = sqrt(squares / (values.size() - 1));
+		double halfWidth = StudentT(values.size() - 1) * deviation / sqrt((double)values.size());
+		std::cout << "  sd " << std::setw(12) << deviation
+			<< "  95% CI [" << mean - halfWidth << ", " << mean + halfWidth << "]";
+	}
+	std::cout << std::endl;
+}
+
+/**	Student T
+*	\n Getter function for the two-sided 95% critical value of Student's t distribution.
+*	@param degrees is the degrees of freedom (at least 1)
+*	@return the value t for which 95% of the distribution lies within [-t, t]
+*/
+double Batch::StudentT(unsigned int degrees) {
+	static const double table[30] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+		2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+		2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+	if (degrees >= 1 && degrees <= 30) {
+		return table[degrees - 1];
+	}
+
+	// Beyond the table, the Cornish-Fisher expansion about the normal quantile is accurate to the third decimal
+	const double z = 1.959964;
+	double n = (degrees > 0 ? degrees : 1);
+	return z + (z * z * z + z) / (4 * n) + (5 * pow(z, 5) + 16 * z * z * z + 3 * z) / (96 * n * n);
+}
@@ -0,0 +1,98 @@
+/**
+*	@file Batch.h
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class declaration for Monte Carlo batch runs. The workload is loaded once; then many independent
+*	virtual-time simulations of it, each with its own seed and configuration variant, run in parallel across the
+*	cores, and their makespans, turnarounds and CPU utilizations are summarized with confidence intervals. The
+*	configuration, log and locks are shared by the whole program, so each run is a forked copy of the loaded
+*	simulator which reports its summary back through a pipe.
+*	@date Monday, April 30, 2018
+*/
+
+//
+// Compiler Guards ////////////////////////
+//
+#ifndef BATCH_H
+#define BATCH_H
+
+//
+// Header Files ///////////////////////////
+//
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <stdint.h>
+#include <sys/types.h>
+#include "Config.h"
+#include "OperatingSystem.h"
+
+extern Config conf;
+
+//
+// Class Declaration ///////////////////////////
+//
+class Batch {
+public:
+	// Constructor
+	Batch(std::string configFile, unsigned int runCount);
+
+	// Sets
+	void SetJobs(unsigned int count);
+	void SetFirstSeed(uint64_t seed);
+	void AddOverride(const std::string &line);
+	void AddVariation(const std::string &line) throw(std::logic_error);
+
+	// Batch functions
+	void Run() throw(std::logic_error);
+
+private:
+	// A configuration the runs are repeated under
+	struct Variant {
+		std::string label;				// The varied lines, for the report
+		std::vector<std::string> lines;	// Lines overriding the configuration file
+		Config config;
+	};
+
+	// Summary of one run, as sent back by the forked run
+	struct Outcome {
+		int completed;					// 1 if the run completed, 0 if it failed
+		double makespan;				// Milliseconds
+		double turnaround;				// Mean over the processes, in milliseconds
+		double utilization;				// Percent
+		char error[256];				// Why the run failed
+	};
+
+	// A forked run which has not yet reported
+	struct Job {
+		Job(pid_t jobPid, int jobPipe, unsigned int jobVariant, unsigned int jobRun) : pid(jobPid), pipe(jobPipe), variant(jobVariant), run(jobRun) {};
+
+		pid_t pid;
+		int pipe;						// Read end of the pipe the run writes its outcome to
+		unsigned int variant;
+		unsigned int run;
+	};
+
+	// Private functions
+	void BuildVariants() throw(std::logic_error);
+	void RunJob(OperatingSystem &os, unsigned int variant, uint64_t seed, int pipe);
+	void Collect(std::vector<Job> &running) throw(std::logic_error);
+	uint64_t Seed(unsigned int variant, unsigned int run) const;
+	void Report() const;
+	static void Summarize(std::string name, const std::vector<double> &values);
+	static double StudentT(unsigned int degrees);
+
+	std::string configFilename;
+	unsigned int runs;					// Runs of each variant
+	unsigned int jobs;					// Runs at once
+	bool seedGiven;
+	uint64_t firstSeed;					// Seed of each variant's first run, if given; else the configured seed
+	std::vector<std::string> overrides;	// Lines overriding the configuration file in every run
+	std::vector<std::pair<std::string, std::vector<std::string> > > variations;	// Keys varied, and their values
+	std::vector<Variant> variants;		// Every combination of the varied values
+	std::vector<std::vector<Outcome> > outcomes;	// Outcome of each run of each variant
+};
+
+#endif	// !BATCH_H
@@ -0,0 +1,539 @@
+/**
+*	@file Bench.cpp
+*	@author Brian Marks
+*	@version 1.0
+*	@details Benchmark suite for the simulator. Measures config parsing, meta-data loading, scheduling against process
+*	count, lock contention, memory allocation latency, log throughput and end-to-end virtual-time simulation, writes the
+*	results as JSON, and compares them against a stored baseline to catch performance regressions.
+*	@date Monday, April 30, 2018
+*/
+
+//
+// Header Files ///////////////////////
+//
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "Config.h"
+#include "Log.h"
+#include "Lock.h"
+#include "OperatingSystem.h"
+#include "ResourceManager.h"
+#include "Semaphore.h"
+#include "Timer.h"
+#include "Trace.h"
+#include "WorkloadGenerator.h"
+
+// Global declaration of shared classes
+Config conf;
+Log logger;
+Trace trace;
+Lock lock;
+
+//
+// Benchmark Results
+//
+
+// One measurement; lower is better unless higherIsBetter
+struct Result {
+	Result(std::string resultName, double resultValue, bool higher) : name(resultName), value(resultValue), higherIsBetter(higher) {};
+
+	std::string name;
+	double value;
+	bool higherIsBetter;
+};
+
+static std::vector<Result> results;
+static std::string workDirectory;
+
+/**	Record
+*	\n Adds a measurement to the results. A measurement taken again in a later trial keeps the best value, which is
+*	the one least disturbed by the rest of the machine.
+*	@param name is the name of the measurement, ending in its unit
+*	@param value is the measured value
+*	@param higherIsBetter is true for throughputs, false for times
+*/
+static void Record(std::string name, double value, bool higherIsBetter) {
+	for (unsigned int i = 0; i < results.size(); i++) {
+		if (results[i].name == name) {
+			if (higherIsBetter ? value > results[i].value : value < results[i].value) {
+				results[i].value = value;
+			}
+			return;
+		}
+	}
+	results.push_back(Result(name, value, higherIsBetter));
+}
+
+//
+// Input Files
+//
+
+/**	Write Config
+*	\n Writes a configuration file for the benchmarks.
+*	@param path is the file written
+*	@param metaData is the meta-data file named by the configuration
+*	@param schedule is the CPU scheduling code
+*/
+static void WriteConfig(std::string path, std::string metaData, std::string schedule) {
+	std::ofstream fout(path.c_str());
+	fout << "Start Simulator Configuration File\n"
+		<< "Version/Phase: 4.0\n"
+		<< "File Path: " << metaData << "\n"
+		<< "Processor Quantum Number: 3\n"
+		<< "CPU Scheduling Code: " << schedule << "\n"
+		<< "Monitor display time {msec}: 20\n"
+		<< "Processor cycle time {msec}: 10\n"
+		<< "Scanner cycle time {msec}: 25\n"
+		<< "Hard drive cycle time {msec}: 15\n"
+		<< "Keyboard cycle time {msec}: 50\n"
+		<< "Memory cycle time {msec}: 20\n"
+		<< "Projector cycle time {msec}: 25\n"
+		<< "System memory {Mbytes}: 1024\n"
+		<< "Memory block size {kbytes}: 128\n"
+		<< "Projector quantity: 2\n"
+		<< "Hard drive quantity: 3\n"
+		<< "Simulation Mode Code: VIRTUAL\n"
+		<< "Log: Log to File\n"
+		<< "Log File Path: " << workDirectory << "/bench.lgf\n"
+		<< "End Simulator Configuration File\n";
+}
+
+/**	Write Workload
+*	\n Writes a synthetic meta-data file; memory operations free what they allocate so large workloads cannot exhaust memory.
+*	@param path is the file written
+*	@param processes is the number of applications
+*	@param operations is the number of operations in each application
+*/
+static void WriteWorkload(std::string path, unsigned long processes, unsigned int operations) {
+	WorkloadGenerator generator;
+	generator.SetProcesses(processes, operations);
+	generator.SetFreeing(true);
+
+	FILE* out = fopen(path.c_str(), "wb");
+	if (out == NULL) {
+		throw std::logic_error("Benchmark workload could not be written.");
+	}
+	generator.Write(out);
+	fclose(out);
+}
+
+/**	Load Config
+*	\n Replaces the global configuration with one read from a file.
+*	@param path is the configuration file
+*	@param overrides are configuration lines which take the place of the file's
+*/
+static void LoadConfig(std::string path, const std::vector<std::string> &overrides = std::vector<std::string>()) {
+	std::vector<char> name(path.begin(), path.end());
+	name.push_back('\0');
+	conf = Config();
+	conf.ConfigInit(&name[0], overrides);
+}
+
+//
+// Benchmarks
+//
+
+/**	Bench Config Parse
+*	\n Times reading the configuration file.
+*/
+static void BenchConfigParse() {
+	std::string path = workDirectory + "/bench.conf";
+	const int repeats = 2000;
+	Timer timer;
+
+	timer.start();
+	for (int i = 0; i < repeats; i++) {
+		LoadConfig(path);
+	}
+	Record("config_parse_us", (double)timer.getElapsedMicroSeconds() / repeats, false);
+}
+
+/**	Bench Meta-Data Load
+*	\n Times reading a large meta-data file into processes.
+*/
+static void BenchMetaDataLoad() {
+	std::string path = workDirectory + "/load.mdf";
+	struct stat status;
+	WriteWorkload(path, 200000, 20);
+	stat(path.c_str(), &status);
+
+	LoadConfig(workDirectory + "/bench.conf");
+	conf.metaDataFilename = path;
+	Timer timer;
+	timer.start();
+	{
+		OperatingSystem os;
+	}
+	double seconds = (double)timer.getElapsedSeconds();
+	Record("metadata_load_mb_per_s", status.st_size / 1e6 / seconds, true);
+	unlink(path.c_str());
+}
+
+/**	Bench Scheduling
+*	\n Times shortest job first scheduling for several process counts, to show how it scales.
+*/
+static void BenchScheduling() {
+	unsigned long counts[] = { 250, 1000, 4000 };
+
+	for (unsigned int i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+		std::string path = workDirectory + "/schedule.mdf";
+		WriteWorkload(path, counts[i], 10);
+		LoadConfig(workDirectory + "/bench.conf");
+		conf.metaDataFilename = path;
+		conf.schedule = "SJF";
+
+		OperatingSystem os;
+		Timer timer;
+		timer.start();
+		os.scheduleProcesses();
+		Record("schedule_sjf_" + std::to_string(counts[i]) + "_processes_ms", (double)timer.getElapsedMilliSeconds(), false);
+		unlink(path.c_str());
+	}
+}
+
+// Shared state for the lock contention benchmark
+static Semaphore* contended;
+static unsigned long counter;
+static const unsigned long lockRounds = 200000;
+
+/**	Lock Thread
+*	\n A process that can be called in the creation of a thread which repeatedly takes and releases the contended lock.
+*	@param threadarg is unused
+*/
+static void* LockThread(void* threadarg) {
+	for (unsigned long i = 0; i < lockRounds; i++) {
+		contended->Wait();
+		counter++;
+		contended->Post();
+	}
+	return NULL;
+}
+
+/**	Bench Lock Contention
+*	\n Times lock hand-offs between 1, 2 and 4 threads sharing one mutex.
+*/
+static void BenchLockContention() {
+	unsigned int threadCounts[] = { 1, 2, 4 };
+
+	for (unsigned int i = 0; i < sizeof(threadCounts) / sizeof(threadCounts[0]); i++) {
+		Semaphore mutex(1);
+		std::vector<pthread_t> threads(threadCounts[i]);
+		contended = &mutex;
+		counter = 0;
+
+		Timer timer;
+		timer.start();
+		for (unsigned int t = 0; t < threads.size(); t++) {
+			pthread_create(&threads[t], NULL, LockThread, NULL);
+		}
+		for (unsigned int t = 0; t < threads.size(); t++) {
+			pthread_join(threads[t], NULL);
+		}
+		double nanoSeconds = (double)timer.getElapsedMicroSeconds() * 1000;
+		Record("lock_" + std::to_string(threadCounts[i]) + "_threads_ns_per_acquire", nanoSeconds / counter, false);
+	}
+}
+
+/**	Bench Memory Allocation
+*	\n Times allocating and freeing a memory block through the resource manager.
+*/
+static void BenchMemoryAllocation() {
+	const unsigned long rounds = 200000;
+	LoadConfig(workDirectory + "/bench.conf");
+	ResourceManager rm;
+	rm.DeclareMemoryClaim(0, 1);
+	unsigned long address;
+
+	Timer timer;
+	timer.start();
+	for (unsigned long i = 0; i < rounds; i++) {
+		rm.CheckSetMemory(0, address);
+		rm.FreeMemory(0, address);
+	}
+	Record("memory_allocate_free_ns", (double)timer.getElapsedMicroSeconds() * 1000 / rounds, false);
+}
+
+/**	Bench Log Throughput
+*	\n Times logging operation starts, to the text file log and to the binary event log.
+*/
+static void BenchLogThroughput() {
+	const unsigned long lines = 500000;
+	const std::string operation = "processing action";
+	const char* settings[] = { "File", "Binary" };
+	const char* names[] = { "log_lines_per_s", "log_binary_events_per_s" };
+
+	for (unsigned int s = 0; s < 2; s++) {
+		LoadConfig(workDirectory + "/bench.conf");
+		conf.logSetting = settings[s];
+		Log log;
+		log.initializeLogSettings();
+
+		Timer timer;
+		timer.start();
+		for (unsigned long i = 0; i < lines; i++) {
+			log.writeOperation(EventLog::OPERATION_START, 0, operation);
+		}
+		Record(names[s], lines / (double)timer.getElapsedSeconds(), true);
+	}
+}
+
+/**	Bench Log Formatting
+*	\n Times formatting a timestamped address line, by the logger and by the iostream formatting it replaced.
+*/
+static void BenchLogFormatting() {
+	const unsigned long lines = 500000;
+	const std::string text = "memory allocated at ";
+	EventLog::Record record;
+	record.event = EventLog::ADDRESS;
+	record.text = &text;
+	std::string line;
+	unsigned long length = 0;
+
+	Timer timer;
+	timer.start();
+	for (unsigned long i = 0; i < lines; i++) {
+		record.time = i * 1000;
+		record.process = i % 64;
+		record.arg = i * 128;
+		EventLog::Render(record, line);
+		length += line.size();
+	}
+	Record("log_format_ns", (double)timer.getElapsedMicroSeconds() * 1000 / lines, false);
+
+	Timer iostreamTimer;
+	iostreamTimer.start();
+	for (unsigned long i = 0; i < lines; i++) {
+		std::ostringstream formatted;
+		formatted << std::fixed << std::setprecision(6) << (long double)(i * 1000) / 1000000 << " - " << "Process "
+			<< std::to_string(i % 64 + 1) << ": " << text << "0x" << std::setfill('0') << std::setw(8) << std::hex << i * 128;
+		length -= formatted.str().size();
+	}
+	Record("log_format_iostream_ns", (double)iostreamTimer.getElapsedMicroSeconds() * 1000 / lines, false);
+
+	if (length != 0) {
+		throw std::logic_error("Log formatting differs in length from iostream formatting.");
+	}
+}
+
+/**	Bench Simulation
+*	\n Times a whole virtual-time simulation, from loading the meta-data to the last process exiting.
+*/
+static void BenchSimulation() {
+	const unsigned long processes = 5000;
+	const unsigned int operations = 20;
+	std::string path = workDirectory + "/simulate.mdf";
+	WriteWorkload(path, processes, operations);
+	LoadConfig(workDirectory + "/bench.conf");
+	conf.metaDataFilename = path;
+
+	Timer timer;
+	timer.start();
+	{
+		OperatingSystem os;
+		os.runSimulation();
+	}
+	double seconds = (double)timer.getElapsedSeconds();
+	Record("simulation_operations_per_s", processes * operations / seconds, true);
+	unlink(path.c_str());
+}
+
+//
+// Checks
+//
+
+/**	Check Memory Free Wake
+*	\n Checks that, in virtual time, a process waiting on memory resumes when another process frees the block with
+*	M{free}, not when that process exits. Process 1 frees the only block at 50ms and exits at 1050ms; process 2, which
+*	waits on the block from 10ms, then exits at 60ms.
+*	@throw the waiting process resumed late
+*/
+static void CheckMemoryFreeWake() {
+	std::string path = workDirectory + "/free.mdf";
+	std::ofstream fout(path.c_str());
+	fout << "Start Program Meta-Data Code:\n"
+		<< "S{begin}0; A{begin}0; M{allocate}1; P{run}5; M{free}1; P{run}100; A{finish}0;\n"
+		<< "A{begin}0; P{run}1; M{allocate}1; P{run}1; A{finish}0; S{finish}0.\n"
+		<< "End Program Meta-Data Code.\n";
+	fout.close();
+
+	std::vector<std::string> overrides;
+	overrides.push_back("Processor quantity: 2");
+	overrides.push_back("Memory block size {kbytes}: 1024000");	// The whole of system memory
+	LoadConfig(workDirectory + "/bench.conf", overrides);
+	conf.metaDataFilename = path;
+
+	Executor::Metrics metrics;
+	{
+		OperatingSystem os;
+		os.runSimulation();
+		metrics = os.getRunMetrics();
+	}
+	unlink(path.c_str());
+
+	if (metrics.meanTurnaround != (1050000 + 60000) / 2) {
+		throw std::logic_error("A process waiting on memory was not resumed when another process freed it.");
+	}
+}
+
+//
+// Results
+//
+
+/**	Write JSON
+*	\n Writes the results as a flat JSON object of name: value.
+*	@param out is the stream written to
+*/
+static void WriteJSON(std::ostream &out) {
+	out << "{\n";
+	for (unsigned int i = 0; i < results.size(); i++) {
+		out << "  \"" << results[i].name << "\": " << std::fixed << std::setprecision(3) << results[i].value
+			<< (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	out << "}\n";
+}
+
+/**	Read JSON
+*	\n Reads a flat JSON object of name: number, as written by WriteJSON.
+*	@param path is the file read
+*	@return the values by name, empty if the file cannot be read
+*/
+static std::map<std::string, double> ReadJSON(std::string path) {
+	std::map<std::string, double> values;
+	std::ifstream fin(path.c_str());
+	std::string line;
+
+	while (std::getline(fin, line)) {
+		std::string::size_type open = line.find('"');
+		std::string::size_type close = line.find('"', open + 1);
+		std::string::size_type colon = line.find(':', close);
+		if (open != std::string::npos && close != std::string::npos && colon != std::string::npos) {
+			values[line.substr(open + 1, close - open - 1)] = atof(line.c_str() + colon + 1);
+		}
+	}
+	return values;
+}
+
+/**	Compare
+*	\n Compares the results against a baseline, flagging any measurement worse by more than the threshold.
+*	@param baseline are the baseline values by name
+*	@param threshold is the allowed slowdown, as a fraction (0.10 for 10%)
+*	@return the number of regressions
+*/
+static unsigned int Compare(const std::map<std::string, double> &baseline, double threshold) {
+	unsigned int regressions = 0;
+
+	std::cerr << "Comparison against baseline (regression threshold " << std::setprecision(0) << threshold * 100 << "%):" << std::endl;
+	for (unsigned int i = 0; i < results.size(); i++) {
+		std::map<std::string, double>::const_iterator base = baseline.find(results[i].name);
+		if (base == baseline.end() || base->second == 0) {
+			std::cerr << "  " << std::left << std::setw(40) << results[i].name << "no baseline" << std::endl;
+			continue;
+		}
+
+		double change = (results[i].value - base->second) / base->second;
+		double slowdown = results[i].higherIsBetter ? -change : change;
+		bool regressed = slowdown > threshold;
+		regressions += regressed;
+		std::cerr << "  " << std::left << std::setw(40) << results[i].name << std::showpos << std::fixed << std::setprecision(1)
+			<< change * 100 << "%" << std::noshowpos << (regressed ? "  REGRESSION" : "") << std::endl;
+	}
+	return regressions;
+}
+
+//
+// Main Function Implementation
+//
+int main(int argc, char* argv[]) {
+	std::string outputPath;
+	std::string baselinePath;
+	double threshold = 0.10;
+	int trials = 3;
+	int option;
+
+	while ((option = getopt(argc, argv, "o:b:t:r:")) != -1) {
+		switch (option) {
+			case 'o':
+				outputPath = optarg;
+				break;
+			case 'b':
+				baselinePath = optarg;
+				break;
+			case 't':
+				threshold = atof(optarg) / 100;
+				break;
+			case 'r':
+				trials = atoi(optarg) > 0 ? atoi(optarg) : 1;
+				break;
+			default:
+				std::cerr << "Usage: Sim04Bench [-o results.json] [-b baseline.json] [-t threshold percent] [-r trials]" << std::endl;
+				return 2;
+		}
+	}
+
+	try {
+		char directory[] = "/tmp/sim04benchXXXXXX";
+		if (mkdtemp(directory) == NULL) {
+			throw std::logic_error("Benchmark directory could not be created.");
+		}
+		workDirectory = directory;
+		WriteConfig(workDirectory + "/bench.conf", workDirectory + "/none.mdf", "FIFO");
+		CheckMemoryFreeWake();
+
+		for (int trial = 1; trial <= trials; trial++) {
+			std::cerr << "Benchmark trial " << trial << " of " << trials << std::endl;
+			BenchConfigParse();
+			BenchMetaDataLoad();
+			BenchScheduling();
+			BenchLockContention();
+			BenchMemoryAllocation();
+			BenchLogThroughput();
+			BenchLogFormatting();
+			BenchSimulation();
+		}
+
+		unlink((workDirectory + "/bench.conf").c_str());
+		rmdir(directory);
+	}
+	catch (std::exception &e) {
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 2;
+	}
+
+	std::cerr << "Best of " << trials << ":" << std::endl;
+	for (unsigned int i = 0; i < results.size(); i++) {
+		std::cerr << "  " << std::left << std::setw(40) << results[i].name << std::fixed << std::setprecision(3) << results[i].value << std::endl;
+	}
+
+	// Results
+	if (outputPath.empty()) {
+		WriteJSON(std::cout);
+	}
+	else {
+		std::ofstream fout(outputPath.c_str());
+		WriteJSON(fout);
+	}
+
+	// Regressions against the baseline
+	if (!baselinePath.empty()) {
+		std::map<std::string, double> baseline = ReadJSON(baselinePath);
+		if (baseline.empty()) {
+			std::cerr << "No baseline read from " << baselinePath << "; record one with make bench-baseline." << std::endl;
+		}
+		else if (Compare(baseline, threshold) > 0) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,171 @@
+/**
+*	@file ChaseLevDeque.h
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class template for a lock-free Chase-Lev work-stealing deque. The owning thread pushes and pops at the
+*	bottom; any thread may steal from the top. Based on Le, Pop, Cohen and Zappa Nardelli, "Correct and Efficient
+*	Work-Stealing for Weak Memory Models" (PPoPP 2013).
+*	@date Thursday, April 26, 2018
+*/
+
+//
+// Compiler Guards ////////////////////////
+//
+#ifndef CHASELEVDEQUE_H
+#define CHASELEVDEQUE_H
+
+//
+// Header Files ///////////////////////////
+//
+#include <atomic>
+#include <vector>
+
+//
+// Class Declaration ///////////////////////////
+//
+template <typename T>
+class ChaseLevDeque {
+public:
+	// Constructor/Destructor
+	ChaseLevDeque(long capacity = 64);
+	~ChaseLevDeque();
+
+	// Owner functions
+	void Push(T item);
+	bool Pop(T &item);
+
+	// Thief functions
+	bool Steal(T &item);
+
+	// Accessors
+	bool Empty() const;
+
+private:
+	// Circular array of items; capacity is always a power of 2
+	struct Array {
+		Array(long size) : capacity(size), items(new std::atomic<T>[size]) {};
+		~Array() { delete[] items; };
+
+		T Get(long i) const { return items[i & (capacity - 1)].load(std::memory_order_relaxed); };
+		void Put(long i, T item) { items[i & (capacity - 1)].store(item, std::memory_order_relaxed); };
+
+		long capacity;
+		std::atomic<T>* items;
+	};
+
+	// Not copyable
+	ChaseLevDeque(const ChaseLevDeque&);
+	ChaseLevDeque& operator=(const ChaseLevDeque&);
+
+	std::atomic<long> top;
+	std::atomic<long> bottom;
+	std::atomic<Array*> array;
+	std::vector<Array*> retired;		// Arrays replaced by growth; a thief may still be reading them
+};
+
+//
+// Class Template Definitions /////////////////
+//
+
+/**	Constructor
+*	\n Creates an empty deque.
+*	@param capacity is the initial capacity; it must be a power of 2
+*/
+template <typename T>
+ChaseLevDeque<T>::ChaseLevDeque(long capacity) : top(0), bottom(0), array(new Array(capacity)) {
+}
+
+/**	Destructor
+*	\n Releases the current array and every array retired by growth.
+*/
+template <typename T>
+ChaseLevDeque<T>::~ChaseLevDeque() {
+	delete array.load(std::memory_order_relaxed);
+	for (unsigned int i = 0; i < retired.size(); i++) {
+		delete retired[i];
+	}
+}
+
+/**	Push
+*	\n Adds an item to the bottom of the deque, doubling the array if it is full. Owner only.
+*	@param item is the item being added
+*/
+template <typename T>
+void ChaseLevDeque<T>::Push(T item) {
+	long b = bottom.load(std::memory_order_relaxed);
+	long t = top.load(std::memory_order_acquire);
+	Array* a = array.load(std::memory_order_relaxed);
+
+	if (b - t > a->capacity - 1) {
+		Array* grown = new Array(a->capacity * 2);
+		for (long i = t; i < b; i++) {
+			grown->Put(i, a->Get(i));
+		}
+		retired.push_back(a);
+		array.store(grown, std::memory_order_release);
+		a = grown;
+	}
+
+	a->Put(b, item);
+	std::atomic_thread_fence(std::memory_order_release);
+	bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+/**	Pop
+*	\n Removes the most recently pushed item from the bottom of the deque. Owner only.
+*	@param item receives the item removed
+*	@return true if an item was removed, false if the deque was empty or a thief took the last item
+*/
+template <typename T>
+bool ChaseLevDeque<T>::Pop(T &item) {
+	long b = bottom.load(std::memory_order_relaxed) - 1;
+	Array* a = array.load(std::memory_order_relaxed);
+	bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	long t = top.load(std::memory_order_relaxed);
+
+	if (t > b) {
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return false;
+	}
+
+	item = a->Get(b);
+	if (t == b) {
+		// Last item: race any thieves for it
+		bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return won;
+	}
+	return true;
+}
+
+/**	Steal
+*	\n Removes the oldest item from the top of the deque. Safe from any thread, including the owner.
+*	@param item receives the item removed
+*	@return true if an item was removed, false if the deque was empty or another thread took the item first
+*/
+template <typename T>
+bool ChaseLevDeque<T>::Steal(T &item) {
+	long t = top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	long b = bottom.load(std::memory_order_acquire);
+
+	if (t >= b) {
+		return false;
+	}
+
+	Array* a = array.load(std::memory_order_acquire);
+	item = a->Get(t);
+	return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+/**	Empty
+*	\n Checks for items in the deque. The answer may be stale as soon as it is returned.
+*	@return true if the deque appeared empty
+*/
+template <typename T>
+bool ChaseLevDeque<T>::Empty() const {
+	return top.load(std::memory_order_acquire) >= bottom.load(std::memory_order_acquire);
+}
+
+#endif	// !CHASELEVDEQUE_H
@@ -1,9 +1,18 @@
 /**
 *	@file Config.cpp
 *	@author Brian Marks
-*	@version 1.4
+*	@version 1.13
 *	@details Class definition for the storing and handling of Configuration file data
 *	@note 1.4 update: Adjusted ReadKey to be compatible with new configuration file format/descriptor options.
+*	@note 1.5 update: Replaced the ifstream reader and ReadKey with a single pass over the file read into memory.
+*	@note 1.6 update: Cycle times may be reloaded while the simulation runs.
+*	@note 1.7 update: Memory sizes are read as 64-bit byte counts into the ResourceSpec, along with the device classes.
+*	@note 1.8 update: Added "Device {name}:" lines, which declare or override device classes in the registry.
+*	@note 1.9 update: Added stochastic service-time models and the "Random Seed".
+*	@note 1.10 update: ConfigInit takes override lines, which take the place of the file's.
+*	@note 1.11 update: Added the "Trace Code" and "Trace File Path".
+*	@note 1.12 update: Added "Log to Binary".
+*	@note 1.13 update: Added the "Log Levels" and "Log Sample Rate".
 *	@date Wednesday, March 28, 2018
 */
 
@@ -11,13 +20,17 @@
 // Header Files /////////////////////////////
 //
 #include "Config.h"
+#include "Profiler.h"
 
 //
 // Class Function Definitions /////////////////
 //
 
+// Definition of the key table, which the key hashes are computed from
+constexpr const char* Config::configReads[KEY_COUNT];
+
 /** Default Constructor
-*	\n Creates an empty Config object
+*	\n Creates an empty Config object, with every optional setting at its default.
 */
 Config::Config() {
 	version = 0.0;
@@ -26,6 +39,28 @@ Config::Config() {
 	metaDataFilename = " ";
 	logPath = " ";
 	logSetting = " ";
+	logLevels = (1 << 3) - 1;			// Every level but debug
+	logSampleRate = 1;
+	timing = std::make_shared<const Timing>();
+
+	processorQuantity = 1;
+	hardDriveCylinders = 0;
+	hardDriveSeekTime = 0;
+	tlbEntries = 16;
+	workingSetWindow = 10;
+
+	simulationMode = "REAL";
+	coreAffinity = "OFF";
+	deviceSelection = "RR";
+	diskScheduling = "FCFS";
+	diskMerging = "OFF";
+	deadlockHandling = "NONE";
+	paging = "OFF";
+	pageReplacement = "FIFO";
+	configReload = "OFF";
+	randomSeed = 1;
+	traceMode = "OFF";
+	tracePath = "";
 }
 
 /** Open Log Path
@@ -44,114 +79,121 @@ void Config::OpenLogPath(std::ofstream& logFile) throw (std::logic_error) {
 }
 /** Get Log Setting
 *	\n A getter function for the log setting denoted by the config file
-*	@return logSetting is a string denoting "Monitor", "Both", or "File"
+*	@return logSetting is a string denoting "Monitor", "Both", "File", or "Binary"
 */
 std::string Config::GetLogSetting() const {
 	return logSetting;
 }
 
 /** Get Operation Time
-*	\n Looks up the run time of a meta-data operation in the configuration information vector
-*	by name, then returns the milliseconds required per cycle for that operation.
+*	\n Looks up the milliseconds required per cycle of a meta-data operation.
 *	@pre Configuration data must be read and processed
-*	@param operationName is the name of the key being looked up in the configInfo vector of pairs<key, timing>.
+*	@param metaCode is the meta-data code of the operation
 *	@param metaDescriptor is the descriptor being conducted
-*	@param metaTime is the number of cycles the process is being ran for
 *	@return The milliseconds/cycle for a specified meta-data operation.
 *	@throw Error finding timing for specified meta-data operation; check config file.
 */
 int Config::GetOperationTime(char metaCode, std::string metaDescriptor ) const throw(std::logic_error){
-	// If calculating a processor based process
+	std::shared_ptr<const Timing> current = std::atomic_load(&timing);		// The table stays valid while held
+	int time = -1;
+
+	// Processor and memory operations are timed by their code, all others by their device
 	if (metaCode == 'P') {
-		for (unsigned int i = 0; i < configInfo.size(); i++) {
-			if (configInfo[i].first == "processor") {		// look up time in config vector
-				return configInfo[i].second;
-			}
-		}
+		time = current->processor;
 	}
-	// If calculating a memory based process
 	else if (metaCode == 'M') {
-		for (unsigned int i = 0; i < configInfo.size(); i++) {
-			if (configInfo[i].first == "memory") {			// look up time in config vector
-				return configInfo[i].second;
-			}
-		}
+		time = current->memory;
 	}
-	// For all other processes
 	else {
-		for (unsigned int i = 0; i < configInfo.size(); i++) {	// look up descriptor in config vector
-			if (configInfo[i].first == metaDescriptor) {		// look up time in config vector
-				return configInfo[i].second;
-			}
+		int device = resources.FindDeviceIndex(metaDescriptor);
+		if (device >= 0 && device < (int)current->devices.size()) {
+			time = current->devices[device];
 		}
 	}
 
-	throw std::logic_error("Config file does not contain timing information for a Meta-Data operation; check Config file.");
+	if (time < 0) {
+		throw std::logic_error("Config file does not contain timing information for a Meta-Data operation; check Config file.");
+	}
+	return time;
+}
+
+/** Get Service Time
+*	\n Calculates the milliseconds a meta-data operation takes, under its device's service-time model.
+*	@pre Configuration data must be read and processed
+*	@param metaCode is the meta-data code of the operation
+*	@param metaDescriptor is the descriptor being conducted
+*	@param cycles is the number of cycles the operation is run for
+*	@return The run time in milliseconds for the meta-data operation
+*	@throw Error finding timing for specified meta-data operation; check config file.
+*/
+long Config::GetServiceTime(char metaCode, std::string metaDescriptor, int cycles) const throw(std::logic_error) {
+	long msPerCycle = GetOperationTime(metaCode, metaDescriptor);
+
+	if (metaCode == 'I' || metaCode == 'O') {
+		const DeviceSpec* device = resources.FindDevice(metaDescriptor);
+		if (device != NULL && device->service == DeviceSpec::FIXED) {
+			return msPerCycle;
+		}
+	}
+	return cycles * msPerCycle;
 }
 
 /** Config Init.
-*	\n Initializes all configuration data by reading from a specified file from the command line.
-*	Data read from file is checked for accuracy, then pertinent data is stored in a vector of pairs.
+*	\n Initializes all configuration data from a specified file from the command line. The file is read into memory
+*	and parsed in one pass, each line's key checked for spelling and its value stored in the member it sets.
 *	Configuration data file MUST include data for the "Log File Path:"; NULL or otherwise.
 *	@param fileIn is a c-style string denoting the name of the configuration data input file
 *	this is passed by argv[1] from Sim01.cpp
-*	@throw Error opening file
+*	@param overrides are configuration lines, e.g. "CPU Scheduling Code: SJF", which take the place of the file's
+*	@throw Error opening file, or in the spelling, format or value of a line
 */
-void Config::ConfigInit(char* fileIn) throw (std::logic_error) {
-	// Declare vars
-	std::string key;					// Key for configInfo
-	std::string loggingType;			// String determining logSetting
-	int value;							// Value for configInfo
-	std::ifstream fin;					// Open input file
-	fin.open(fileIn);
+void Config::ConfigInit(char* fileIn, const std::vector<std::string> &overrides) throw (std::logic_error) {
+	PROFILE_ZONE("config parse");
+	configFilename = fileIn;
 
+	// Read the whole file at once; it is a few hundred bytes, too small to gain from mapping
+#ifdef _WIN32
+	std::ifstream fin(fileIn, std::ios::binary);
 	if (!fin.good()) {
 		throw std::logic_error("Unresolved config file name; check command line parameter.");
 	}
-
-	// Read from file
-	ReadKey(fin, '\n');					// read in "Start Simulator Config. File"
-	ReadKey(fin, ' ');					// read in "Version/Phase:"
-	fin >> version;						// read in version number
-	fin.get();							// eat newline character
-	ReadKey(fin, ':');					// read in "File Path:"
-	fin.get();							// eat space
-	std::getline(fin, metaDataFilename);			// read in MetaData file name
-	
-	// Make sure meta-data file is of .mdf extention
-	if (metaDataFilename.substr(metaDataFilename.size() - 4) != ".mdf")
-		throw std::logic_error("Meta-data file specified has wrong extention (.mdf); check configuration file.");
-	
-	// Get quantum number and schedule type
-	ReadKey(fin, ':');
-	fin >> std::ws >> quantumNumber;
-	fin.get();
-	ReadKey(fin, ':');
-	fin >> std::ws >> schedule;
-	fin.get();
-
-	// Get remaining information before "Log:"
-	while (fin.peek() != 'L') {				// while next item isn't "Log:"
-		key = ReadKey(fin, ':');			// read in process name (first for configInfo)
-		fin >> value;						// read in timing value (second for configInfo)
-		fin.get();							// eat newline character
-		configInfo.push_back(std::make_pair(key, value));			// store key/value pair in vector
+	std::string contents((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+#else
+	int fd = open(fileIn, O_RDONLY);
+	struct stat status;
+	if (fd < 0 || fstat(fd, &status) != 0) {
+		if (fd >= 0) {
+			close(fd);
+		}
+		throw std::logic_error("Unresolved config file name; check command line parameter.");
 	}
+	std::string contents(status.st_size, '\0');
+	size_t size = 0;
+	while (size < contents.size()) {
+		ssize_t bytes = read(fd, &contents[size], contents.size() - size);
+		if (bytes <= 0) {
+			break;
+		}
+		size += bytes;
+	}
+	close(fd);
+	contents.resize(size);
+#endif
 
-	ReadKey(fin, ' ');					// read in "Log:"
-	std::getline(fin, loggingType);		// read in Logging configuration
-	SetLogSetting(loggingType);			// set logSetting
-	ReadKey(fin, ':');					// read in "Log File Path:"
-	fin.get();							// eat space
-	std::getline(fin, logPath);			// read in log path
-	ReadKey(fin, 'e');					// read in "End Simulator Configuration File"
-
-	// Done with configInfo for config purposes; Change format of configInfo to fit meta-data
-	for (unsigned int i = 0; i < configInfo.size(); i++) {
-		configInfo[i].first[0] = tolower(configInfo[i].first[0]);		// Make first letter of each descriptor lower-case
+	// A key given twice keeps its first value, so the overrides go straight after the start line
+	if (!overrides.empty()) {
+		std::string::size_type start = contents.find(configReads[START]);
+		if (start != std::string::npos) {
+			std::string::size_type lineEnd = contents.find('\n', start);
+			std::string lines = "\n";
+			for (unsigned int i = 0; i < overrides.size(); i++) {
+				lines += overrides[i] + "\n";
+			}
+			contents.insert(lineEnd == std::string::npos ? contents.size() : lineEnd, lines);
+		}
 	}
 
-	fin.close();
+	ParseText(contents.data(), contents.data() + contents.size());
 }
 
 /** Set Log Setting
@@ -171,55 +213,715 @@ void Config::SetLogSetting(std::string type) throw(std::logic_error) {
 	else if (type == "Log to Both") {
 		logSetting = "Both";
 	}
+	else if (type == "Log to Binary") {
+		logSetting = "Binary";
+	}
 	else {
 		throw std::logic_error("The logging type is invalid; check config file.");
 	}
 }
 
-/**	Read Key
-*	\n Checks either a line or timing descriptor in the config file for accuracy in formatting and spelling,
-*	then reformats it for use in output.
-*	Updated to include the System memory specification in the config file.
-*	@param fin is an input filestream object passed by reference
-*	@param delimiter is the character at which the function will stop reading from the file
-*	@return A reformatted string which holds the timing descriptor or debugging information
-*	@throw Error caused by spelling/formatting error in config file line or timing descriptor
+/**	Set Log Levels
+*	\n Reads the levels of log line to write, as a comma separated list of LIFECYCLE (processes being started, resumed
+*	and removed, and the reports), OPERATION (operations starting and ending), RESOURCE (memory being allocated and
+*	freed) and DEBUG (work stealing and memory waits).
+*	@param levels is the list specified by the config file
+*	@throw a level is misspelled
+*/
+void Config::SetLogLevels(std::string levels) throw(std::logic_error) {
+	const char* names[] = { "LIFECYCLE", "OPERATION", "RESOURCE", "DEBUG" };
+	const unsigned int count = sizeof(names) / sizeof(names[0]);
+
+	logLevels = 0;
+	std::istringstream list(levels);
+	std::string level;
+	while (std::getline(list, level, ',')) {
+		level.erase(0, level.find_first_not_of(" \t"));
+		level.erase(level.find_last_not_of(" \t") + 1);
+
+		unsigned int i = 0;
+		while (i < count && level != names[i]) {
+			i++;
+		}
+		if (i == count) {
+			throw std::logic_error("Log levels must be LIFECYCLE, OPERATION, RESOURCE or DEBUG; check configuration file.");
+		}
+		logLevels |= 1 << i;
+	}
+}
+
+/**	Parse Text
+*	\n Reads the configuration lines from "Start Simulator Configuration File" to "End Simulator Configuration File".
+*	Each line is a key, then a colon and its value; leading and trailing blanks are ignored. A key given twice keeps
+*	its first value.
+*	@param pos is the first character of the file
+*	@param end is one past the last character of the file
+*	@throw a key is misspelled, a value is not a number, or a required key is missing
 */
-std::string Config::ReadKey(std::ifstream& fin, const char delimiter) throw(std::logic_error) {
-	std::string key;					// Will hold the description for the following value in the config file
-	std::getline(fin, key, delimiter);	// Get line from the config file
+void Config::ParseText(const char* pos, const char* end) throw(std::logic_error) {
+	bool read[KEY_COUNT] = {};
+	Timing parsed;
+	unsigned int projectors = 0;
+	unsigned int hardDrives = 0;
+	int monitorTime = -1, scannerTime = -1, hardDriveTime = -1, keyboardTime = -1, projectorTime = -1;
+	std::vector<std::pair<std::string, std::string> > deviceLines;		// Device name and settings, in file order
+
+	while (pos < end && !read[END]) {
+		// Split the line at its first colon; the meta-data path may hold more
+		const char* lineEnd = (const char*)memchr(pos, '\n', end - pos);
+		if (lineEnd == NULL) {
+			lineEnd = end;
+		}
+		const char* colon = (const char*)memchr(pos, ':', lineEnd - pos);
+		const char* keyEnd = (colon != NULL ? colon : lineEnd);
+		const char* valueBegin = (colon != NULL ? colon + 1 : lineEnd);
+		const char* valueEnd = lineEnd;
 
-	for (unsigned int i = 0; i < (sizeof(configReads) / sizeof(configReads[0])); i++) {
-		if (key == configReads[i]) {
-			switch (i) {				// Depending on the process name, shorten key to single term
-			case 5:
-				key = "Monitor";
+		while (keyEnd > pos && isspace((unsigned char)keyEnd[-1])) {
+			keyEnd--;
+		}
+		while (valueBegin < valueEnd && isspace((unsigned char)*valueBegin)) {
+			valueBegin++;
+		}
+		while (valueEnd > valueBegin && isspace((unsigned char)valueEnd[-1])) {
+			valueEnd--;
+		}
+
+		const char* keyBegin = pos;
+		pos = lineEnd + 1;
+		if (keyEnd == keyBegin) {
+			continue;						// blank line
+		}
+
+		// Device lines name the device in the key: Device {name}
+		const size_t devicePrefix = sizeof("Device {") - 1;
+		if ((size_t)(keyEnd - keyBegin) > devicePrefix + 1 && memcmp(keyBegin, "Device {", devicePrefix) == 0 && keyEnd[-1] == '}') {
+			if (!read[START]) {
+				throw std::logic_error("Format/Spelling inaccurate; check config file.");
+			}
+			std::string name(keyBegin + devicePrefix, keyEnd - 1);
+			bool seen = false;
+			for (unsigned int i = 0; i < deviceLines.size(); i++) {
+				seen = seen || deviceLines[i].first == name;
+			}
+			if (!seen) {
+				deviceLines.push_back(std::make_pair(name, std::string(valueBegin, valueEnd)));
+			}
+			continue;
+		}
+
+		Key key = FindKey(keyBegin, keyEnd - keyBegin);
+		if (read[START] != (key != START)) {
+			throw std::logic_error("Format/Spelling inaccurate; check config file.");		// Start line must come first, once
+		}
+		if (read[key]) {
+			continue;
+		}
+		read[key] = true;
+
+		std::string value(valueBegin, valueEnd);
+		switch (key) {
+			case VERSION:
+				version = atof(value.c_str());
+				break;
+			case FILE_PATH:
+				metaDataFilename = value;
+				break;
+			case QUANTUM_NUMBER:
+				quantumNumber = ReadNumber(key, value);
+				break;
+			case SCHEDULING_CODE:
+				schedule = value;
+				break;
+			case MONITOR_TIME:
+				monitorTime = ReadNumber(key, value);
+				break;
+			case PROCESSOR_TIME:
+				parsed.processor = ReadNumber(key, value);
+				break;
+			case SCANNER_TIME:
+				scannerTime = ReadNumber(key, value);
+				break;
+			case HARD_DRIVE_TIME:
+				hardDriveTime = ReadNumber(key, value);
+				break;
+			case KEYBOARD_TIME:
+				keyboardTime = ReadNumber(key, value);
+				break;
+			case MEMORY_TIME:
+				parsed.memory = ReadNumber(key, value);
+				break;
+			case PROJECTOR_TIME:
+				projectorTime = ReadNumber(key, value);
+				break;
+			case MEMORY_KBYTES:
+				resources.memoryBytes = ReadBytes(key, value, 1000ULL);
+				break;
+			case MEMORY_MBYTES:
+				resources.memoryBytes = ReadBytes(key, value, 1000000ULL);
+				break;
+			case MEMORY_GBYTES:
+				resources.memoryBytes = ReadBytes(key, value, 1000000000ULL);
+				break;
+			case BLOCK_KBYTES:
+				resources.blockBytes = ReadBytes(key, value, 1000ULL);
+				break;
+			case BLOCK_MBYTES:
+				resources.blockBytes = ReadBytes(key, value, 1000000ULL);
+				break;
+			case BLOCK_GBYTES:
+				resources.blockBytes = ReadBytes(key, value, 1000000000ULL);
+				break;
+			case PROJECTOR_QUANTITY:
+				projectors = ReadNumber(key, value);
+				break;
+			case HARD_DRIVE_QUANTITY:
+				hardDrives = ReadNumber(key, value);
+				break;
+			case SIMULATION_MODE_CODE:
+				simulationMode = value;
+				break;
+			case PROCESSOR_QUANTITY:
+				processorQuantity = ReadNumber(key, value);
+				break;
+			case CORE_AFFINITY_CODE:
+				coreAffinity = value;
+				break;
+			case DEVICE_SELECTION_CODE:
+				deviceSelection = value;
+				break;
+			case DISK_SCHEDULING_CODE:
+				diskScheduling = value;
+				break;
+			case DISK_MERGING_CODE:
+				diskMerging = value;
+				break;
+			case HARD_DRIVE_CYLINDERS:
+				hardDriveCylinders = ReadNumber(key, value);
+				break;
+			case HARD_DRIVE_SEEK_TIME:
+				hardDriveSeekTime = ReadNumber(key, value);
 				break;
-			case 6:
-				key = "Processor";
+			case DEADLOCK_HANDLING_CODE:
+				deadlockHandling = value;
 				break;
-			case 7:
-				key = "Scanner";
+			case PAGING_CODE:
+				paging = value;
 				break;
-			case 8:
-				key = "Hard drive";
+			case MEMORY_TLB_ENTRIES:
+				tlbEntries = ReadNumber(key, value);
 				break;
-			case 9:
-				key = "Keyboard";
+			case WORKING_SET_WINDOW:
+				workingSetWindow = ReadNumber(key, value);
 				break;
-			case 10:
-				key = "Memory";
+			case PAGE_REPLACEMENT_CODE:
+				pageReplacement = value;
 				break;
-			case 11:
-				key = "Projector";
+			case CONFIG_RELOAD_CODE:
+				configReload = value;
 				break;
+			case RANDOM_SEED:
+				randomSeed = ReadBytes(key, value, 1);
+				break;
+			case TRACE_CODE:
+				traceMode = value;
+				break;
+			case TRACE_FILE_PATH:
+				tracePath = value;
+				break;
+			case LOG:
+				SetLogSetting(value);
+				break;
+			case LOG_FILE_PATH:
+				logPath = value;
+				break;
+			case LOG_LEVELS:
+				SetLogLevels(value);
+				break;
+			case LOG_SAMPLE_RATE: {
+				int rate = ReadNumber(key, value);
+				if (rate < 1) {
+					throw std::logic_error("Log sample rate must be at least 1; check configuration file.");
+				}
+				logSampleRate = rate;
+				break;
+			}
 			default:
-				return key;
+				break;						// Start and End lines hold no value
+		}
+	}
+
+	// Check for the lines every configuration file must have
+	Key required[] = { FILE_PATH, QUANTUM_NUMBER, SCHEDULING_CODE, LOG, LOG_FILE_PATH, END };
+	for (unsigned int i = 0; i < sizeof(required) / sizeof(required[0]); i++) {
+		if (!read[required[i]]) {
+			throw std::logic_error("Config file is missing \"" + std::string(configReads[required[i]]) + "\"; check config file.");
+		}
+	}
+
+	// Make sure meta-data file is of .mdf extention
+	if (metaDataFilename.size() < 4 || metaDataFilename.substr(metaDataFilename.size() - 4) != ".mdf")
+		throw std::logic_error("Meta-data file specified has wrong extention (.mdf); check configuration file.");
+
+	if (configReload != "ON" && configReload != "OFF") {
+		throw std::logic_error("Config reload code must be ON or OFF; check configuration file.");
+	}
+	if (traceMode != "OFF" && traceMode != "RECORD" && traceMode != "REPLAY") {
+		throw std::logic_error("Trace code must be OFF, RECORD or REPLAY; check configuration file.");
+	}
+
+	// Built-in devices; keyboard, scanner and monitor are each a single shared device
+	resources.devices.clear();
+	resources.devices.push_back(DeviceSpec("projector", projectors, projectorTime, DeviceSpec::FIFO, "PROJ"));
+	resources.devices.push_back(DeviceSpec("hard drive", hardDrives, hardDriveTime, DeviceSpec::DISK, "HDD"));
+	resources.devices.push_back(DeviceSpec("keyboard", 1, keyboardTime, DeviceSpec::SHARED, ""));
+	resources.devices.push_back(DeviceSpec("scanner", 1, scannerTime, DeviceSpec::SHARED, ""));
+	resources.devices.push_back(DeviceSpec("monitor", 1, monitorTime, DeviceSpec::SHARED, ""));
+	resources.devices[1].diskScheduling = diskScheduling;
+	resources.devices[1].cylinders = hardDriveCylinders;
+	resources.devices[1].seekTime = hardDriveSeekTime;
+	for (unsigned int i = 0; i < resources.devices.size(); i++) {
+		parsed.devices.push_back(resources.devices[i].cycleTime);
+	}
+
+	// Device lines add to or override the built-in devices
+	for (unsigned int i = 0; i < deviceLines.size(); i++) {
+		ReadDevice(deviceLines[i].first, deviceLines[i].second, parsed);
+	}
+
+	std::atomic_store(&timing, std::shared_ptr<const Timing>(std::make_shared<const Timing>(parsed)));
+}
+
+/**	Reload Timing
+*	\n Publishes the cycle times of a freshly read configuration. Operations already started keep the times they
+*	looked up; every later lookup sees the new times. Safe to call while other threads look up times.
+*	@param fresh is the configuration read again from the file
+*/
+void Config::ReloadTiming(const Config &fresh) {
+	std::shared_ptr<const Timing> current = std::atomic_load(&timing);
+	std::shared_ptr<const Timing> freshTiming = std::atomic_load(&fresh.timing);
+	Timing reloaded = *current;
+
+	// Devices keep this configuration's order; a device the fresh file no longer has keeps its time
+	reloaded.processor = freshTiming->processor;
+	reloaded.memory = freshTiming->memory;
+	for (unsigned int i = 0; i < resources.devices.size(); i++) {
+		int device = fresh.resources.FindDeviceIndex(resources.devices[i].name);
+		if (device >= 0) {
+			reloaded.devices[i] = freshTiming->devices[device];
+		}
+	}
+
+	std::atomic_store(&timing, std::shared_ptr<const Timing>(std::make_shared<const Timing>(reloaded)));
+}
+
+/**	Fixed Changes
+*	\n Lists the settings of a freshly read configuration which differ from this one but are fixed once the
+*	simulation starts, so that a reload can report them as ignored.
+*	@param fresh is the configuration read again from the file
+*	@return the keys of the changed settings
+*/
+std::vector<std::string> Config::FixedChanges(const Config &fresh) const {
+	std::vector<std::string> changes;
+
+	if (fresh.metaDataFilename != metaDataFilename) {
+		changes.push_back(configReads[FILE_PATH]);
+	}
+	if (fresh.quantumNumber != quantumNumber) {
+		changes.push_back(configReads[QUANTUM_NUMBER]);
+	}
+	if (fresh.schedule != schedule) {
+		changes.push_back(configReads[SCHEDULING_CODE]);
+	}
+	if (fresh.resources.memoryBytes != resources.memoryBytes) {
+		changes.push_back("System memory");
+	}
+	if (fresh.resources.blockBytes != resources.blockBytes) {
+		changes.push_back("Memory block size");
+	}
+	for (unsigned int i = 0; i < resources.devices.size(); i++) {
+		const DeviceSpec &current = resources.devices[i];
+		const DeviceSpec* device = fresh.resources.FindDevice(current.name);
+		if (device == NULL || device->quantity != current.quantity || device->label != current.label || device->service != current.service
+			|| device->queue != current.queue || device->diskScheduling != current.diskScheduling
+			|| device->cylinders != current.cylinders || device->seekTime != current.seekTime
+			|| device->sigma != current.sigma || device->histogramFile != current.histogramFile) {
+			changes.push_back("Device {" + current.name + "}");
+		}
+	}
+	for (unsigned int i = 0; i < fresh.resources.devices.size(); i++) {
+		if (resources.FindDeviceIndex(fresh.resources.devices[i].name) < 0) {
+			changes.push_back("Device {" + fresh.resources.devices[i].name + "}");
+		}
+	}
+	if (fresh.processorQuantity != processorQuantity) {
+		changes.push_back(configReads[PROCESSOR_QUANTITY]);
+	}
+	if (fresh.hardDriveCylinders != hardDriveCylinders) {
+		changes.push_back(configReads[HARD_DRIVE_CYLINDERS]);
+	}
+	if (fresh.hardDriveSeekTime != hardDriveSeekTime) {
+		changes.push_back(configReads[HARD_DRIVE_SEEK_TIME]);
+	}
+	if (fresh.tlbEntries != tlbEntries) {
+		changes.push_back(configReads[MEMORY_TLB_ENTRIES]);
+	}
+	if (fresh.workingSetWindow != workingSetWindow) {
+		changes.push_back(configReads[WORKING_SET_WINDOW]);
+	}
+	if (fresh.simulationMode != simulationMode || fresh.coreAffinity != coreAffinity || fresh.deviceSelection != deviceSelection
+		|| fresh.diskScheduling != diskScheduling || fresh.diskMerging != diskMerging || fresh.deadlockHandling != deadlockHandling
+		|| fresh.paging != paging || fresh.pageReplacement != pageReplacement) {
+		changes.push_back("policy codes");
+	}
+	if (fresh.randomSeed != randomSeed) {
+		changes.push_back(configReads[RANDOM_SEED]);
+	}
+	if (fresh.traceMode != traceMode || fresh.tracePath != tracePath) {
+		changes.push_back(configReads[TRACE_CODE]);
+	}
+	if (fresh.logSetting != logSetting || fresh.logPath != logPath) {
+		changes.push_back(configReads[LOG]);
+	}
+	if (fresh.logLevels != logLevels || fresh.logSampleRate != logSampleRate) {
+		changes.push_back(configReads[LOG_LEVELS]);
+	}
+
+	return changes;
+}
+
+/**	Find Key
+*	\n Identifies a config file key. The hash of every valid key is computed at compile time, so a single switch finds
+*	the only key the text could be; a duplicate case would not compile, so no two keys share a hash. The text is then
+*	compared with that key to catch misspellings.
+*	@param key is the key as read from the file
+*	@param length is the length of the key
+*	@return the key read
+*	@throw Error caused by spelling/formatting error in config file key
+*/
+Config::Key Config::FindKey(const char* key, size_t length) const throw(std::logic_error) {
+	Key found;
+
+#define CONFIG_KEY_CASE(name) case KeyHash(name): found = name; break;
+	switch (Hash(key, length)) {
+		CONFIG_KEY_CASE(START)
+		CONFIG_KEY_CASE(VERSION)
+		CONFIG_KEY_CASE(FILE_PATH)
+		CONFIG_KEY_CASE(QUANTUM_NUMBER)
+		CONFIG_KEY_CASE(SCHEDULING_CODE)
+		CONFIG_KEY_CASE(MONITOR_TIME)
+		CONFIG_KEY_CASE(PROCESSOR_TIME)
+		CONFIG_KEY_CASE(SCANNER_TIME)
+		CONFIG_KEY_CASE(HARD_DRIVE_TIME)
+		CONFIG_KEY_CASE(KEYBOARD_TIME)
+		CONFIG_KEY_CASE(MEMORY_TIME)
+		CONFIG_KEY_CASE(PROJECTOR_TIME)
+		CONFIG_KEY_CASE(MEMORY_KBYTES)
+		CONFIG_KEY_CASE(MEMORY_MBYTES)
+		CONFIG_KEY_CASE(MEMORY_GBYTES)
+		CONFIG_KEY_CASE(BLOCK_KBYTES)
+		CONFIG_KEY_CASE(BLOCK_MBYTES)
+		CONFIG_KEY_CASE(BLOCK_GBYTES)
+		CONFIG_KEY_CASE(PROJECTOR_QUANTITY)
+		CONFIG_KEY_CASE(HARD_DRIVE_QUANTITY)
+		CONFIG_KEY_CASE(SIMULATION_MODE_CODE)
+		CONFIG_KEY_CASE(PROCESSOR_QUANTITY)
+		CONFIG_KEY_CASE(CORE_AFFINITY_CODE)
+		CONFIG_KEY_CASE(DEVICE_SELECTION_CODE)
+		CONFIG_KEY_CASE(DISK_SCHEDULING_CODE)
+		CONFIG_KEY_CASE(DISK_MERGING_CODE)
+		CONFIG_KEY_CASE(HARD_DRIVE_CYLINDERS)
+		CONFIG_KEY_CASE(HARD_DRIVE_SEEK_TIME)
+		CONFIG_KEY_CASE(DEADLOCK_HANDLING_CODE)
+		CONFIG_KEY_CASE(PAGING_CODE)
+		CONFIG_KEY_CASE(MEMORY_TLB_ENTRIES)
+		CONFIG_KEY_CASE(WORKING_SET_WINDOW)
+		CONFIG_KEY_CASE(PAGE_REPLACEMENT_CODE)
+		CONFIG_KEY_CASE(CONFIG_RELOAD_CODE)
+		CONFIG_KEY_CASE(RANDOM_SEED)
+		CONFIG_KEY_CASE(TRACE_CODE)
+		CONFIG_KEY_CASE(TRACE_FILE_PATH)
+		CONFIG_KEY_CASE(LOG)
+		CONFIG_KEY_CASE(LOG_FILE_PATH)
+		CONFIG_KEY_CASE(LOG_LEVELS)
+		CONFIG_KEY_CASE(LOG_SAMPLE_RATE)
+		CONFIG_KEY_CASE(END)
+		default:
+			throw std::logic_error("Format/Spelling inaccurate; check config file.");		// This key was not found in list of possible config reads, throw error
+	}
+#undef CONFIG_KEY_CASE
+
+	if (Length(configReads[found]) != length || memcmp(configReads[found], key, length) != 0) {
+		throw std::logic_error("Format/Spelling inaccurate; check config file.");
+	}
+	return found;
+}
+
+/**	Read Number
+*	\n Converts the value of a numeric setting.
+*	@param key is the key the value was given for
+*	@param value is the value as read from the file
+*	@return the value
+*	@throw the value is not a whole number
+*/
+int Config::ReadNumber(Key key, const std::string &value) const throw(std::logic_error) {
+	char* numberEnd;
+	long number = strtol(value.c_str(), &numberEnd, 10);
+
+	if (value.empty() || *numberEnd != '\0') {
+		throw std::logic_error("Value of \"" + std::string(configReads[key]) + "\" is not a whole number; check config file.");
+	}
+	return (int)number;
+}
+
+/**	Read Bytes
+*	\n Converts the value of a memory size setting to bytes.
+*	@param key is the key the value was given for
+*	@param value is the value as read from the file
+*	@param unit is the number of bytes in the key's unit
+*	@return the size in bytes
+*	@throw the value is not a whole number, or is too large to count in bytes
+*/
+uint64_t Config::ReadBytes(Key key, const std::string &value, uint64_t unit) const throw(std::logic_error) {
+	char* numberEnd;
+	errno = 0;
+	unsigned long long number = strtoull(value.c_str(), &numberEnd, 10);
+
+	if (value.empty() || value[0] == '-' || *numberEnd != '\0') {
+		throw std::logic_error("Value of \"" + std::string(configReads[key]) + "\" is not a whole number; check config file.");
+	}
+	if (errno == ERANGE || number > UINT64_MAX / unit) {
+		throw std::logic_error("Value of \"" + std::string(configReads[key]) + "\" is too large; check config file.");
+	}
+	return (uint64_t)number * unit;
+}
+
+/**	Read Device
+*	\n Adds a device class to the registry from a "Device {name}:" line, or overrides the settings of a device already
+*	in it. The value is a comma separated list of settings, each given as setting=value:
+*	units (number of units), cycle (milliseconds per cycle), service (PER_CYCLE, FIXED, EXPONENTIAL, LOGNORMAL, or
+*	EMPIRICAL), sigma (shape of a LOGNORMAL service time), histogram (file of an EMPIRICAL service time),
+*	queue (SHARED, FIFO, or a disk scheduling code: FCFS, SSTF, SCAN, CSCAN), label (logged with the unit number),
+*	cylinders and seek (microseconds per cylinder), for a disk scheduled device. A new device has one unit and a FIFO queue.
+*	@param name is the device's meta-data descriptor
+*	@param value is the list of settings
+*	@param parsed receives the device's cycle time
+*	@throw the name is already a meta-data descriptor, a setting is unknown or has an invalid value, or units is 0
+*/
+void Config::ReadDevice(const std::string &name, const std::string &value, Timing &parsed) throw(std::logic_error) {
+	// Descriptors of the other meta-data codes cannot name a device, nor can anything which would not read back
+	const char* reserved[] = { "begin", "finish", "run", "allocate", "free", "block" };
+	bool usable = (name.find_first_of(":{}") == std::string::npos);
+	for (unsigned int i = 0; i < sizeof(reserved) / sizeof(reserved[0]); i++) {
+		usable = usable && name != reserved[i];
+	}
+	if (!usable) {
+		throw std::logic_error("Device \"" + name + "\" cannot be used as a device name; check config file.");
+	}
+
+	int index = resources.FindDeviceIndex(name);
+	if (index < 0) {
+		resources.devices.push_back(DeviceSpec(name, 1, -1, DeviceSpec::FIFO, name));
+		parsed.devices.push_back(-1);
+		index = resources.devices.size() - 1;
+	}
+	DeviceSpec &device = resources.devices[index];
+
+	std::string::size_type begin = 0;
+	while (begin < value.size()) {
+		std::string::size_type comma = value.find(',', begin);
+		if (comma == std::string::npos) {
+			comma = value.size();
+		}
+		std::string field = value.substr(begin, comma - begin);
+		begin = comma + 1;
+
+		std::string::size_type equals = field.find('=');
+		std::string setting = field.substr(0, equals);
+		std::string setValue = (equals == std::string::npos ? "" : field.substr(equals + 1));
+		setting.erase(0, setting.find_first_not_of(" \t"));
+		setting.erase(setting.find_last_not_of(" \t") + 1);
+		setValue.erase(0, setValue.find_first_not_of(" \t"));
+		setValue.erase(setValue.find_last_not_of(" \t") + 1);
+		if (setting.empty() && equals == std::string::npos) {
+			continue;
+		}
+
+		// Numeric settings
+		char* numberEnd;
+		long number = strtol(setValue.c_str(), &numberEnd, 10);
+		bool isNumber = !setValue.empty() && *numberEnd == '\0' && number >= 0;
+		if ((setting == "units" || setting == "cycle" || setting == "cylinders" || setting == "seek") && !isNumber) {
+			throw std::logic_error("Setting \"" + setting + "\" of device \"" + name + "\" is not a whole number; check config file.");
+		}
+
+		if (setting == "units") {
+			if (number < 1) {
+				throw std::logic_error("Device \"" + name + "\" must have at least one unit; check config file.");
 			}
+			device.quantity = (unsigned int)number;
+		}
+		else if (setting == "cycle") {
+			device.cycleTime = (int)number;
+			parsed.devices[index] = (int)number;
+		}
+		else if (setting == "cylinders") {
+			device.cylinders = (int)number;
+		}
+		else if (setting == "seek") {
+			device.seekTime = (int)number;
+		}
+		else if (setting == "label" && !setValue.empty()) {
+			device.label = setValue;
+		}
+		else if (setting == "service" && (setValue == "PER_CYCLE" || setValue == "FIXED")) {
+			device.service = (setValue == "FIXED" ? DeviceSpec::FIXED : DeviceSpec::PER_CYCLE);
+		}
+		else if (setting == "service" && (setValue == "EXPONENTIAL" || setValue == "LOGNORMAL" || setValue == "EMPIRICAL")) {
+			device.service = (setValue == "EXPONENTIAL" ? DeviceSpec::EXPONENTIAL
+				: setValue == "LOGNORMAL" ? DeviceSpec::LOGNORMAL : DeviceSpec::EMPIRICAL);
+		}
+		else if (setting == "sigma" && !setValue.empty() && strtod(setValue.c_str(), &numberEnd) >= 0 && *numberEnd == '\0') {
+			device.sigma = strtod(setValue.c_str(), NULL);
+		}
+		else if (setting == "histogram" && !setValue.empty()) {
+			device.histogramFile = setValue;
+		}
+		else if (setting == "queue" && (setValue == "SHARED" || setValue == "FIFO")) {
+			device.queue = (setValue == "SHARED" ? DeviceSpec::SHARED : DeviceSpec::FIFO);
+		}
+		else if (setting == "queue" && (setValue == "FCFS" || setValue == "SSTF" || setValue == "SCAN" || setValue == "CSCAN")) {
+			device.queue = DeviceSpec::DISK;
+			device.diskScheduling = setValue;
+		}
+		else {
+			throw std::logic_error("Setting \"" + field + "\" of device \"" + name + "\" is unknown or invalid; check config file.");
+		}
+	}
+
+	// An empirical device without a cycle time is estimated, e.g. by the scheduler, at its histogram's mean
+	if (device.service == DeviceSpec::EMPIRICAL) {
+		ReadHistogram(device);
+		if (device.cycleTime < 0) {
+			double mean = 0;
+			for (unsigned int i = 0; i < device.histogramValues.size(); i++) {
+				double weight = device.histogramWeights[i] - (i == 0 ? 0 : device.histogramWeights[i - 1]);
+				mean += device.histogramValues[i] * weight;
+			}
+			device.cycleTime = (int)(mean / device.histogramWeights.back() + 0.5);
+			parsed.devices[index] = device.cycleTime;
+		}
+	}
+}
+
+/**	Read Histogram
+*	\n Reads the histogram of an EMPIRICAL service time. Each line of the file is a bin: its milliseconds per cycle,
+*	then optionally its weight (1 if not given). Blank lines and lines starting with '#' are skipped.
+*	@param device is the device whose histogram file is read
+*	@throw the file cannot be read, a line is malformed, or no bin has any weight
+*/
+void Config::ReadHistogram(DeviceSpec &device) const throw(std::logic_error) {
+	std::ifstream fin(device.histogramFile.c_str());
+	if (device.histogramFile.empty() || !fin.good()) {
+		throw std::logic_error("Histogram of device \"" + device.name + "\" cannot be read; check config file.");
+	}
 
-			return key;					// Format/Spelling is accurate, return good key
+	device.histogramValues.clear();
+	device.histogramWeights.clear();
+	double total = 0;
+	std::string line;
+	while (std::getline(fin, line)) {
+		const char* pos = line.c_str();
+		char* numberEnd;
+		while (isspace((unsigned char)*pos)) {
+			pos++;
 		}
+		if (*pos == '\0' || *pos == '#') {
+			continue;
+		}
+
+		double value = strtod(pos, &numberEnd);
+		double weight = 1;
+		bool valid = (numberEnd != pos && value >= 0);
+		pos = numberEnd;
+		while (isspace((unsigned char)*pos)) {
+			pos++;
+		}
+		if (valid && *pos != '\0') {
+			weight = strtod(pos, &numberEnd);
+			valid = (numberEnd != pos && weight >= 0);
+			for (pos = numberEnd; valid && *pos != '\0'; pos++) {
+				valid = isspace((unsigned char)*pos);
+			}
+		}
+		if (!valid) {
+			throw std::logic_error("Histogram of device \"" + device.name + "\" has a malformed line \"" + line + "\"; check histogram file.");
+		}
+
+		total += weight;
+		device.histogramValues.push_back(value);
+		device.histogramWeights.push_back(total);
 	}
 
-	throw std::logic_error("Format/Spelling inaccurate; check config file.");		// This key was not found in list of possible config reads, throw error
+	if (total <= 0) {
+		throw std::logic_error("Histogram of device \"" + device.name + "\" has no weight; check histogram file.");
+	}
+}
+
+/**	Sample Service Time
+*	\n Draws the time a request occupies the device under its service-time model. Deterministic models return the mean.
+*	@param meanMicroSeconds is the deterministic time of the request
+*	@param cycles is the number of cycles of the request
+*	@param random is the generator to draw from
+*	@return the time (us) the request occupies the device
+*/
+long Config::DeviceSpec::SampleServiceTime(long meanMicroSeconds, int cycles, Random &random) const {
+	double sample = meanMicroSeconds;
+
+	if (service == EXPONENTIAL) {
+		sample = meanMicroSeconds * random.Exponential();
+	}
+	else if (service == LOGNORMAL) {
+		// Shift the location so that the mean stays at meanMicroSeconds
+		sample = meanMicroSeconds * std::exp(sigma * random.Normal() - sigma * sigma / 2);
+	}
+	else if (service == EMPIRICAL) {
+		double target = random.Uniform() * histogramWeights.back();
+		size_t bin = std::upper_bound(histogramWeights.begin(), histogramWeights.end(), target) - histogramWeights.begin();
+		sample = cycles * histogramValues[std::min(bin, histogramValues.size() - 1)] * 1000;
+	}
+
+	return (long)(sample + 0.5);
+}
+
+/**	Blocks
+*	\n Getter function for the number of whole memory blocks in system memory.
+*	@return the number of memory blocks, or 0 if no block size is given
+*/
+uint64_t Config::ResourceSpec::Blocks() const {
+	return (blockBytes == 0 ? 0 : memoryBytes / blockBytes);
+}
+
+/**	Find Device
+*	\n Looks up a device class by name.
+*	@param name is the device's meta-data descriptor
+*	@return the device class, or NULL if the machine has no such device
+*/
+const Config::DeviceSpec* Config::ResourceSpec::FindDevice(const std::string &name) const {
+	int index = FindDeviceIndex(name);
+	return (index < 0 ? NULL : &devices[index]);
+}
+
+/**	Find Device Index
+*	\n Looks up the position of a device class in the registry.
+*	@param name is the device's meta-data descriptor
+*	@return the index of the device class, or -1 if the machine has no such device
+*/
+int Config::ResourceSpec::FindDeviceIndex(const std::string &name) const {
+	for (unsigned int i = 0; i < devices.size(); i++) {
+		if (devices[i].name == name) {
+			return i;
+		}
+	}
+	return -1;
 }
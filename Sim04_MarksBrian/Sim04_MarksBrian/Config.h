@@ -1,10 +1,24 @@
 /**
 *	@file Config.h
 *	@author Brian Marks
-*	@version 1.4
+*	@version 1.13
 *	@details Class declaration for the storing and handling of Configuration file data
 *	@note 1.4 update: Adjusted ReadKey to be compatible with new configuration file format/descriptor options.
-*	@date Wednesday, April 19, 2018
+*	@note 1.5 update: The configuration file is read into memory and parsed in one pass. Keys are matched through a
+*	hash computed at compile time from the table of valid keys, and every setting is stored in a typed member.
+*	@note 1.6 update: The cycle times are held in a snapshot which may be replaced while the simulation runs. Readers
+*	take a reference to the current snapshot, so an operation keeps the timing it started with.
+*	@note 1.7 update: Memory and devices are described by a ResourceSpec produced once by the parser. Memory sizes are
+*	64-bit byte counts, and each device class carries its own name, quantity and cycle time.
+*	@note 1.8 update: Devices form a registry. Besides the built-in devices, "Device {name}:" lines declare new device
+*	classes or override built-in ones, each with its units, cycle time, service-time model and queueing discipline.
+*	@note 1.9 update: Added stochastic service-time models (exponential, lognormal, empirical histogram), drawn from
+*	generators seeded by the "Random Seed".
+*	@note 1.10 update: Lines given on the command line override the file's, for batch runs.
+*	@note 1.11 update: Added the "Trace Code" and "Trace File Path", to record and replay real-time runs.
+*	@note 1.12 update: Added "Log to Binary", which writes the log as binary event records for the simlog tool.
+*	@note 1.13 update: Added the "Log Levels" to log and the "Log Sample Rate" of operation and resource events.
+*	@date Monday, April 30, 2018
 */
 
 //
@@ -18,16 +32,104 @@
 //
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <vector>
+#include <memory>
 #include <stdexcept>
 #include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+#include <algorithm>
+#include <stdint.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+#include "Random.h"
 
 //
 // Class Function Declarations ////////////
 //
 class Config {
 public:
+	// Every key of the configuration file, in the order of configReads
+	enum Key {
+		START, VERSION, FILE_PATH, QUANTUM_NUMBER, SCHEDULING_CODE,
+		MONITOR_TIME, PROCESSOR_TIME, SCANNER_TIME, HARD_DRIVE_TIME, KEYBOARD_TIME, MEMORY_TIME, PROJECTOR_TIME,
+		MEMORY_KBYTES, MEMORY_MBYTES, MEMORY_GBYTES, BLOCK_KBYTES, BLOCK_MBYTES, BLOCK_GBYTES,
+		PROJECTOR_QUANTITY, HARD_DRIVE_QUANTITY, SIMULATION_MODE_CODE, PROCESSOR_QUANTITY, CORE_AFFINITY_CODE,
+		DEVICE_SELECTION_CODE, DISK_SCHEDULING_CODE, DISK_MERGING_CODE, HARD_DRIVE_CYLINDERS, HARD_DRIVE_SEEK_TIME,
+		DEADLOCK_HANDLING_CODE, PAGING_CODE, MEMORY_TLB_ENTRIES, WORKING_SET_WINDOW, PAGE_REPLACEMENT_CODE,
+		CONFIG_RELOAD_CODE, RANDOM_SEED, TRACE_CODE, TRACE_FILE_PATH, LOG, LOG_FILE_PATH,
+		LOG_LEVELS, LOG_SAMPLE_RATE, END,
+		KEY_COUNT
+	};
+
+	// Milliseconds per cycle of each operation; -1 if the file gives none
+	struct Timing {
+		Timing() : processor(-1), memory(-1) {};
+
+		int processor;
+		int memory;
+		std::vector<int> devices;	// One per device class, in the order of ResourceSpec::devices
+	};
+
+	// A class of I/O device, named as in the meta-data descriptors
+	struct DeviceSpec {
+		// How long a request occupies the device
+		enum ServiceModel {
+			PER_CYCLE,				// Its cycles times the cycle time
+			FIXED,					// The cycle time, whatever its cycles
+			EXPONENTIAL,			// Exponentially distributed, with its cycles times the cycle time as the mean
+			LOGNORMAL,				// Lognormally distributed with shape sigma, with its cycles times the cycle time as the mean
+			EMPIRICAL				// Its cycles times a time per cycle drawn from a histogram read from a file
+		};
+
+		// How the device's units serve their requests
+		enum Queue {
+			SHARED,					// Every request is served at once, on no particular unit
+			FIFO,					// Each unit serves its requests back to back, in arrival order
+			DISK					// Each unit orders its requests by cylinder under a disk scheduling code
+		};
+
+		DeviceSpec(std::string deviceName, unsigned int units, int msPerCycle, Queue discipline, std::string unitLabel)
+			: name(deviceName), label(unitLabel), quantity(units), cycleTime(msPerCycle), service(PER_CYCLE), queue(discipline),
+			diskScheduling("FCFS"), cylinders(0), seekTime(0), sigma(0.5) {};
+
+		long SampleServiceTime(long meanMicroSeconds, int cycles, Random &random) const;
+
+		std::string name;
+		std::string label;			// Logged with the unit number, e.g. "HDD 0"
+		unsigned int quantity;		// Number of units
+		int cycleTime;				// Milliseconds per cycle when the simulation starts; -1 if the file gives none
+		ServiceModel service;
+		Queue queue;
+		std::string diskScheduling;	// FCFS, SSTF, SCAN, or CSCAN, for a DISK queue
+		int cylinders;				// Cylinders per unit of a DISK queue, or 0 if requests may name any cylinder
+		int seekTime;				// Microseconds per cylinder the head moves
+		double sigma;				// Shape of a LOGNORMAL service time
+		std::string histogramFile;	// File of an EMPIRICAL service time
+		std::vector<double> histogramValues;	// Milliseconds per cycle of each bin of the histogram
+		std::vector<double> histogramWeights;	// Running total of the bins' weights, for drawing a bin
+	};
+
+	// The resources of the simulated machine
+	struct ResourceSpec {
+		ResourceSpec() : memoryBytes(0), blockBytes(0) {};
+
+		uint64_t Blocks() const;
+		int FindDeviceIndex(const std::string &name) const;
+		const DeviceSpec* FindDevice(const std::string &name) const;
+
+		uint64_t memoryBytes;
+		uint64_t blockBytes;
+		std::vector<DeviceSpec> devices;
+	};
+
 	// Constructors
 	Config();
 
@@ -35,28 +137,76 @@ public:
 	void OpenLogPath(std::ofstream& logFile) throw(std::logic_error);
 	std::string GetLogSetting() const;
 	int GetOperationTime(char metaCode, std::string metaDescriptor) const throw(std::logic_error);
+	long GetServiceTime(char metaCode, std::string metaDescriptor, int cycles) const throw(std::logic_error);
 
 	// Sets
-	void ConfigInit(char* fileIn) throw (std::logic_error);
+	void ConfigInit(char* fileIn, const std::vector<std::string> &overrides = std::vector<std::string>()) throw (std::logic_error);
 
 	// Additional functions
 	void SetLogSetting(std::string type) throw(std::logic_error);
-	std::string ReadKey(std::ifstream& fin, char delimiter) throw(std::logic_error);
-	//void ShowConfig(std::ofstream& fout);
+	void SetLogLevels(std::string levels) throw(std::logic_error);
+	void ReloadTiming(const Config &fresh);
+	std::vector<std::string> FixedChanges(const Config &fresh) const;
+
+	// Key hashing: FNV-1a, usable at compile time
+	static constexpr uint32_t Hash(const char* text, size_t length, uint32_t hash = 2166136261u) {
+		return length == 0 ? hash : Hash(text + 1, length - 1, (hash ^ (unsigned char)*text) * 16777619u);
+	}
+	static constexpr size_t Length(const char* text) {
+		return *text == '\0' ? 0 : 1 + Length(text + 1);
+	}
+	static constexpr uint32_t KeyHash(Key key) {
+		return Hash(configReads[key], Length(configReads[key]));
+	}
 
 	// Public Data
-	std::vector< std::pair<std::string, int> > configInfo;	// vector of pairs<process name, timing> stores all meta-data names and timings
+	std::string configFilename;								// Config file path, for reloading
 	std::string metaDataFilename;							// Meta Data file path
 	std::string logPath;									// Log file path
-	std::string logSetting;									// Log to monitor, file, or both
+	std::string logSetting;									// Log to monitor, file, or both; None in batch runs
+	unsigned int logLevels;									// Bit n set to log the lines of Log::Level n
+	unsigned int logSampleRate;								// 1 in this many operations has its operation and resource events logged
 	std::string schedule;									// Schedule type: FIFO, Priority, or Shortest First
 	int quantumNumber;										// Processor Quantum Number
 	double version;											// Config file version description
 
+	// Resources
+	ResourceSpec resources;
+	int processorQuantity;
+	int hardDriveCylinders;
+	int hardDriveSeekTime;									// Microseconds per cylinder
+	int tlbEntries;
+	int workingSetWindow;
+
+	// Policy codes
+	std::string simulationMode;
+	std::string coreAffinity;
+	std::string deviceSelection;
+	std::string diskScheduling;
+	std::string diskMerging;
+	std::string deadlockHandling;
+	std::string paging;
+	std::string pageReplacement;
+	std::string configReload;								// ON to reload the cycle times when the file changes
+	uint64_t randomSeed;									// Seed of every stochastic service time
+	std::string traceMode;									// OFF, or RECORD or REPLAY the threads' interleaving
+	std::string tracePath;									// Trace file recorded or replayed
+
 private:
+	// Private functions
+	void ParseText(const char* pos, const char* end) throw(std::logic_error);
+	Key FindKey(const char* key, size_t length) const throw(std::logic_error);
+	int ReadNumber(Key key, const std::string &value) const throw(std::logic_error);
+	uint64_t ReadBytes(Key key, const std::string &value, uint64_t unit) const throw(std::logic_error);
+	void ReadDevice(const std::string &name, const std::string &value, Timing &parsed) throw(std::logic_error);
+	void ReadHistogram(DeviceSpec &device) const throw(std::logic_error);
+
+	// Cycle times; replaced whole, only through std::atomic_load and std::atomic_store
+	std::shared_ptr<const Timing> timing;
+
 	// Error Handling Data Items
-	std::string configReads[23] = { "Start Simulator Configuration File",
-		"Version/Phase:",
+	static constexpr const char* configReads[KEY_COUNT] = { "Start Simulator Configuration File",
+		"Version/Phase",
 		"File Path",
 		"Processor Quantum Number",
 		"CPU Scheduling Code",
@@ -74,10 +224,29 @@ private:
 		"Memory block size {Mbytes}",
 		"Memory block size {Gbytes}",
 		"Projector quantity",
-		"Hard drive quantity", 
-		"Log:",
+		"Hard drive quantity",
+		"Simulation Mode Code",
+		"Processor quantity",
+		"Core Affinity Code",
+		"Device Selection Code",
+		"Disk Scheduling Code",
+		"Disk Merging Code",
+		"Hard drive cylinders",
+		"Hard drive seek time {usec}",
+		"Deadlock Handling Code",
+		"Paging Code",
+		"Memory TLB entries",
+		"Memory working set window",
+		"Page Replacement Code",
+		"Config Reload Code",
+		"Random Seed",
+		"Trace Code",
+		"Trace File Path",
+		"Log",
 		"Log File Path",
-		"End Simulator Configuration Fil" };		// Array holding all possible valid config file key reads (for spell checking)
+		"Log Levels",
+		"Log Sample Rate",
+		"End Simulator Configuration File" };		// Array holding all possible valid config file keys (for spell checking)
 };
 
 #endif // !CONFIG_H
@@ -0,0 +1,221 @@
+/**
+*	@file ConfigWatcher.cpp
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class implementation for the watcher which reloads the configuration while the simulation runs.
+*	@date Monday, April 30, 2018
+*/
+
+//
+// Header Files ///////////////////////////
+//
+#include "ConfigWatcher.h"
+#include <cerrno>
+#include <unistd.h>
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+//
+// Class Function Definitions /////////////////
+//
+
+int ConfigWatcher::hangupPipe = -1;
+
+/**	Constructor
+*	\n Creates a watcher which is not yet watching.
+*/
+ConfigWatcher::ConfigWatcher() : stopping(false), reloads(0) {
+	config = NULL;
+	inotifyFd = -1;
+	wakePipe[0] = -1;
+	wakePipe[1] = -1;
+	running = false;
+}
+
+/**	Destructor
+*	\n Stops watching, if still watching.
+*/
+ConfigWatcher::~ConfigWatcher() {
+	Stop();
+}
+
+/**	Start
+*	\n Starts watching the file a configuration was read from, and catching SIGHUP.
+*	@param watched is the configuration to reload; it must outlive the watcher
+*	@throw the file cannot be watched
+*/
+void ConfigWatcher::Start(Config &watched) throw(std::logic_error) {
+#ifdef __linux__
+	if (running) {
+		return;
+	}
+	config = &watched;
+
+	std::string::size_type slash = config->configFilename.find_last_of('/');
+	directory = (slash == std::string::npos ? "." : config->configFilename.substr(0, slash + 1));
+	filename = (slash == std::string::npos ? config->configFilename : config->configFilename.substr(slash + 1));
+
+	// Rewriting the file in place closes it after writing; editors which save by renaming move a new file onto it
+	inotifyFd = inotify_init1(IN_CLOEXEC);
+	if (inotifyFd < 0 || inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+		if (inotifyFd >= 0) {
+			close(inotifyFd);
+			inotifyFd = -1;
+		}
+		throw std::logic_error("Config file cannot be watched for reloading; check configuration file.");
+	}
+	if (pipe2(wakePipe, O_CLOEXEC | O_NONBLOCK) != 0) {
+		close(inotifyFd);
+		inotifyFd = -1;
+		throw std::logic_error("Config file cannot be watched for reloading; check configuration file.");
+	}
+
+	// SIGHUP asks for a reload; the handler only writes to the pipe, which is safe in a signal handler
+	hangupPipe = wakePipe[1];
+	struct sigaction hangup;
+	hangup.sa_handler = HangupHandler;
+	sigemptyset(&hangup.sa_mask);
+	hangup.sa_flags = SA_RESTART;
+	sigaction(SIGHUP, &hangup, &previousHangup);
+
+	stopping = false;
+	pthread_create(&thread, NULL, WatchThread, (void*)this);
+	running = true;
+#else
+	throw std::logic_error("Config reloading is only supported on Linux; check configuration file.");
+#endif
+}
+
+/**	Stop
+*	\n Stops watching and restores the previous SIGHUP handler. Does nothing if not watching.
+*/
+void ConfigWatcher::Stop() {
+	if (!running) {
+		return;
+	}
+
+	stopping = true;
+	ssize_t written = write(wakePipe[1], "s", 1);
+	(void)written;
+	pthread_join(thread, NULL);
+	running = false;
+
+	sigaction(SIGHUP, &previousHangup, NULL);
+	hangupPipe = -1;
+	close(wakePipe[0]);
+	close(wakePipe[1]);
+	close(inotifyFd);
+	wakePipe[0] = -1;
+	wakePipe[1] = -1;
+	inotifyFd = -1;
+}
+
+/**	Get Reloads
+*	\n Getter function for the number of successful reloads.
+*	@return the number of times new cycle times were published
+*/
+unsigned int ConfigWatcher::GetReloads() const {
+	return reloads;
+}
+
+/**	Watch Thread
+*	\n A process that can be called in the creation of a thread which waits for reload requests.
+*	@param threadarg is the watcher
+*/
+void* ConfigWatcher::WatchThread(void* threadarg) {
+	((ConfigWatcher*)threadarg)->Watch();
+	return NULL;
+}
+
+/**	Hangup Handler
+*	\n Signal handler for SIGHUP: wakes the watcher thread to reload.
+*	@param signal is SIGHUP
+*/
+void ConfigWatcher::HangupHandler(int signal) {
+	int savedErrno = errno;
+	if (hangupPipe >= 0) {
+		ssize_t written = write(hangupPipe, "h", 1);
+		(void)written;
+	}
+	errno = savedErrno;
+}
+
+/**	Watch
+*	\n Waits for the configuration file to change or for SIGHUP, reloading each time, until stopped. Changes which
+*	arrive together cause a single reload.
+*/
+void ConfigWatcher::Watch() {
+#ifdef __linux__
+	struct pollfd waits[2];
+	waits[0].fd = inotifyFd;
+	waits[0].events = POLLIN;
+	waits[1].fd = wakePipe[0];
+	waits[1].events = POLLIN;
+	char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+	while (!stopping) {
+		if (poll(waits, 2, -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+
+		bool reload = false;
+		if (waits[0].revents & POLLIN) {
+			ssize_t length = read(inotifyFd, events, sizeof(events));
+			for (ssize_t offset = 0; offset < length; ) {
+				const struct inotify_event* event = (const struct inotify_event*)(events + offset);
+				if (event->len > 0 && filename == event->name) {
+					reload = true;
+				}
+				offset += sizeof(struct inotify_event) + event->len;
+			}
+		}
+		if (waits[1].revents & POLLIN) {
+			char requests[64];
+			ssize_t length = read(wakePipe[0], requests, sizeof(requests));
+			for (ssize_t i = 0; i < length; i++) {
+				if (requests[i] == 'h') {
+					reload = true;
+				}
+			}
+		}
+
+		if (reload && !stopping) {
+			Reload();
+		}
+	}
+#endif
+}
+
+/**	Reload
+*	\n Reads the configuration file again and publishes its cycle times. A file which cannot be read leaves the current
+*	configuration in place.
+*/
+void ConfigWatcher::Reload() {
+	Config fresh;
+	std::vector<char> path(config->configFilename.begin(), config->configFilename.end());
+	path.push_back('\0');
+
+	try {
+		fresh.ConfigInit(&path[0]);
+	}
+	catch (std::logic_error &error) {
+		logger.writeWithTimestamp(std::string("OS: configuration reload failed, keeping current configuration: ") + error.what());
+		return;
+	}
+
+	config->ReloadTiming(fresh);
+	reloads++;
+
+	std::string line = "OS: configuration reloaded, new cycle times apply to operations started from now";
+	std::vector<std::string> ignored = config->FixedChanges(fresh);
+	for (unsigned int i = 0; i < ignored.size(); i++) {
+		line += (i == 0 ? "; ignored until restart: " : ", ") + ignored[i];
+	}
+	logger.writeWithTimestamp(line);
+}
@@ -0,0 +1,72 @@
+/**
+*	@file ConfigWatcher.h
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class declaration for a watcher which reloads the configuration while the simulation runs. A thread
+*	waits for the configuration file to be rewritten (inotify) or for SIGHUP, reads the file again, and publishes its
+*	cycle times as the new snapshot. Operations already started keep the times they looked up; settings fixed at
+*	startup, such as resource quantities and policy codes, are reported as ignored until the next run.
+*	@date Monday, April 30, 2018
+*/
+
+//
+// Compiler Guards ////////////////////////
+//
+#ifndef CONFIGWATCHER_H
+#define CONFIGWATCHER_H
+
+//
+// Header Files ///////////////////////////
+//
+#include <atomic>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <pthread.h>
+#include <signal.h>
+#include "Config.h"
+#include "Log.h"
+
+extern Log logger;
+
+//
+// Class Declaration ///////////////////////////
+//
+class ConfigWatcher {
+public:
+	// Constructor and Destructor
+	ConfigWatcher();
+	~ConfigWatcher();
+
+	// Watching functions
+	void Start(Config &watched) throw(std::logic_error);
+	void Stop();
+
+	// Accessors
+	unsigned int GetReloads() const;
+
+private:
+	ConfigWatcher(const ConfigWatcher&);
+	ConfigWatcher& operator=(const ConfigWatcher&);
+
+	// Private functions
+	static void* WatchThread(void* threadarg);
+	static void HangupHandler(int signal);
+	void Watch();
+	void Reload();
+
+	Config* config;							// Configuration whose cycle times are replaced
+	std::string directory;					// Directory holding the file; watched so a file replaced by rename is seen
+	std::string filename;
+	int inotifyFd;
+	int wakePipe[2];						// Written by the SIGHUP handler to reload, and by Stop to end the thread
+	pthread_t thread;
+	bool running;
+	std::atomic<bool> stopping;
+	std::atomic<unsigned int> reloads;
+	struct sigaction previousHangup;
+
+	static int hangupPipe;					// Write end of the running watcher's wake pipe, for the signal handler
+};
+
+#endif	// !CONFIGWATCHER_H
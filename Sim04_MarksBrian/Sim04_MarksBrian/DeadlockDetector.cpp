@@ -0,0 +1,287 @@
+/**
+*	@file DeadlockDetector.cpp
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class implementation for incremental deadlock detection and Banker's algorithm avoidance.
+*	@date Friday, April 27, 2018
+*/
+
+//
+// Header Files ///////////////////////////
+//
+#include "DeadlockDetector.h"
+
+//
+// Class Function Definitions /////////////////
+//
+
+/**	Constructor
+*	\n Creates an empty graph which only tracks requests.
+*/
+DeadlockDetector::DeadlockDetector() {
+	searches = 0;
+	mode = NO_HANDLING;
+}
+
+/**	Set Mode
+*	\n Translates the "Deadlock Handling Code" from the config file into a deadlock handling mode.
+*	@param code is NONE, DETECT, or AVOID
+*	@throw the code is not a known mode
+*/
+void DeadlockDetector::SetMode(std::string code) throw(std::logic_error) {
+	if (code == "NONE") {
+		mode = NO_HANDLING;
+	}
+	else if (code == "DETECT") {
+		mode = DETECTION;
+	}
+	else if (code == "AVOID") {
+		mode = AVOIDANCE;
+	}
+	else {
+		throw std::logic_error("Deadlock handling code is either incompatible or undefined; check configuration file.");
+	}
+}
+
+/**	Set Resources
+*	\n Defines the resources in the graph, all units free, and clears every process.
+*	@param resourceNames names each resource, for error messages
+*	@param resourceUnits is the number of units of each resource
+*/
+void DeadlockDetector::SetResources(const std::vector<std::string> &resourceNames, const std::vector<unsigned int> &resourceUnits) {
+	names = resourceNames;
+	available = resourceUnits;
+	holders.assign(resourceUnits.size(), std::map<int, unsigned int>());
+	processes.clear();
+}
+
+/**	Declare Claim
+*	\n Records the most units of a resource a process may hold at once, for the Banker's algorithm.
+*	@param processID is the process making the claim
+*	@param resource is the resource claimed
+*	@param units is the maximum number of units the process will hold
+*	@throw in AVOID mode, the claim exceeds the units the system has, so the process could never be admitted
+*/
+void DeadlockDetector::DeclareClaim(int processID, unsigned int resource, unsigned int units) throw(std::logic_error) {
+	unsigned int total = available[resource];
+	for (std::map<int, unsigned int>::const_iterator it = holders[resource].begin(); it != holders[resource].end(); ++it) {
+		total += it->second;
+	}
+	if (mode == AVOIDANCE && units > total) {
+		throw std::logic_error("Process " + std::to_string(processID + 1) + " claims more " + names[resource]
+			+ " than the system has; check meta-data file.");
+	}
+
+	GetProcess(processID).claim[resource] = units;
+}
+
+/**	Can Grant
+*	\n Decides whether one unit of a resource may be given to a process now. In AVOID mode the unit is granted only
+*	if every process could still run to completion afterwards.
+*	@param processID is the process requesting the unit
+*	@param resource is the resource requested
+*	@return true if the unit may be granted
+*	@throw in AVOID mode, the request exceeds the process' maximum claim
+*/
+bool DeadlockDetector::CanGrant(int processID, unsigned int resource) throw(std::logic_error) {
+	if (available[resource] == 0) {
+		return false;
+	}
+	if (mode != AVOIDANCE) {
+		return true;
+	}
+
+	Process &process = GetProcess(processID);
+	if (process.held[resource] + 1 > process.claim[resource]) {
+		throw std::logic_error("Process " + std::to_string(processID + 1) + " requested more " + names[resource]
+			+ " than its maximum claim; check meta-data file.");
+	}
+
+	// Pretend to grant the unit, then check the resulting state
+	Grant(processID, resource);
+	bool safe = IsSafe();
+	Release(processID, resource, 1);
+
+	return safe;
+}
+
+/**	Grant
+*	\n Gives one unit of a resource to a process, replacing its request edge with an assignment edge.
+*	@pre CanGrant must have returned true.
+*	@param processID is the process receiving the unit
+*	@param resource is the resource granted
+*/
+void DeadlockDetector::Grant(int processID, unsigned int resource) {
+	Process &process = GetProcess(processID);
+	available[resource]--;
+	process.held[resource]++;
+	holders[resource][processID]++;
+	process.waitingOn = -1;
+}
+
+/**	Request
+*	\n Adds a request edge for a process which must wait for a resource. In DETECT mode, the graph reachable from
+*	the process is then searched; a new deadlock must include the new edge, so this search finds any deadlock.
+*	@param processID is the process which is waiting
+*	@param resource is the resource it waits on
+*	@throw in DETECT mode, the request completes a deadlock; the request edge is withdrawn first
+*/
+void DeadlockDetector::Request(int processID, unsigned int resource) throw(std::logic_error) {
+	GetProcess(processID).waitingOn = resource;
+	if (mode != DETECTION) {
+		return;
+	}
+
+	std::vector<int> deadlocked = FindDeadlock(processID);
+	if (deadlocked.empty()) {
+		return;
+	}
+	Withdraw(processID);
+
+	std::string members;
+	for (unsigned int i = 0; i < deadlocked.size(); i++) {
+		members += (i == 0 ? "" : ", ") + std::to_string(deadlocked[i] + 1);
+	}
+	throw std::logic_error("Deadlock detected: process " + std::to_string(processID + 1) + " waits on " + names[resource]
+		+ " which can only be released by blocked processes " + members + "; check meta-data file.");
+}
+
+/**	Withdraw
+*	\n Removes a process' request edge, as when its wait is abandoned.
+*	@param processID is the process which has stopped waiting
+*/
+void DeadlockDetector::Withdraw(int processID) {
+	GetProcess(processID).waitingOn = -1;
+}
+
+/**	Release
+*	\n Returns units of a resource held by a process.
+*	@param processID is the process releasing the units
+*	@param resource is the resource released
+*	@param units is the number of units released; at most the number held
+*/
+void DeadlockDetector::Release(int processID, unsigned int resource, unsigned int units) {
+	Process &process = GetProcess(processID);
+	if (units > process.held[resource]) {
+		units = process.held[resource];
+	}
+	available[resource] += units;
+	process.held[resource] -= units;
+
+	if (process.held[resource] == 0) {
+		holders[resource].erase(processID);
+	}
+	else {
+		holders[resource][processID] -= units;
+	}
+}
+
+/**	Get Mode
+*	\n Getter function for the deadlock handling mode.
+*	@return the deadlock handling mode
+*/
+DeadlockDetector::Mode DeadlockDetector::GetMode() const {
+	return mode;
+}
+
+/**	Get Process
+*	\n Finds a process node, adding nodes as process IDs are first seen.
+*	@param processID is the process
+*	@return the process' node
+*/
+DeadlockDetector::Process& DeadlockDetector::GetProcess(int processID) {
+	if ((unsigned int)processID >= processes.size()) {
+		processes.resize(processID + 1);
+	}
+	Process &process = processes[processID];
+	if (process.held.size() != available.size()) {
+		process.held.assign(available.size(), 0);
+		process.claim.assign(available.size(), 0);
+	}
+	return process;
+}
+
+/**	Is Safe
+*	\n Banker's safety check: the state is safe if the processes holding resources can finish in some order, each
+*	using the units it holds plus those freed by the processes before it. A process holding nothing can always
+*	finish once every holder has, since no claim exceeds the system, so only holders are checked.
+*	@return true if the state is safe
+*/
+bool DeadlockDetector::IsSafe() {
+	std::vector<unsigned int> work = available;
+	std::vector<int> pending;
+
+	// Collect each holder once
+	searches++;
+	for (unsigned int r = 0; r < holders.size(); r++) {
+		for (std::map<int, unsigned int>::const_iterator it = holders[r].begin(); it != holders[r].end(); ++it) {
+			if (processes[it->first].visited != searches) {
+				processes[it->first].visited = searches;
+				pending.push_back(it->first);
+			}
+		}
+	}
+
+	// Finish any process whose remaining need fits in the work vector, until none is left or none fits
+	bool progress = true;
+	while (!pending.empty() && progress) {
+		progress = false;
+		for (unsigned int i = 0; i < pending.size(); i++) {
+			Process &process = processes[pending[i]];
+			bool fits = true;
+			for (unsigned int r = 0; r < work.size() && fits; r++) {
+				unsigned int need = (process.claim[r] > process.held[r] ? process.claim[r] - process.held[r] : 0);
+				fits = (need <= work[r]);
+			}
+			if (fits) {
+				for (unsigned int r = 0; r < work.size(); r++) {
+					work[r] += process.held[r];
+				}
+				pending[i] = pending.back();
+				pending.pop_back();
+				i--;
+				progress = true;
+			}
+		}
+	}
+
+	return pending.empty();
+}
+
+/**	Find Deadlock
+*	\n Searches the graph from a waiting process. A waiting process can only proceed if some holder of the resource
+*	it waits on can proceed, since a unit is all it needs; so the process is deadlocked exactly when every process
+*	reachable along request and assignment edges is waiting on a resource with no free units. Each edge is
+*	followed at most once.
+*	@param processID is the process which has just started waiting
+*	@return the deadlocked processes, or an empty set if the process can still proceed
+*/
+std::vector<int> DeadlockDetector::FindDeadlock(int processID) {
+	std::vector<int> reached;
+	std::vector<int> stack;
+
+	searches++;
+	processes[processID].visited = searches;
+	stack.push_back(processID);
+
+	while (!stack.empty()) {
+		int current = stack.back();
+		stack.pop_back();
+		reached.push_back(current);
+
+		int resource = processes[current].waitingOn;
+		if (resource < 0 || available[resource] > 0) {
+			return std::vector<int>();			// A running process, or a free unit: the wait will end
+		}
+
+		for (std::map<int, unsigned int>::const_iterator it = holders[resource].begin(); it != holders[resource].end(); ++it) {
+			if (processes[it->first].visited != searches) {
+				processes[it->first].visited = searches;
+				stack.push_back(it->first);
+			}
+		}
+	}
+
+	std::sort(reached.begin(), reached.end());
+	return reached;
+}
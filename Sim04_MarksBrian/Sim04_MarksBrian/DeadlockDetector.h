@@ -0,0 +1,84 @@
+/**
+*	@file DeadlockDetector.h
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class declaration for a resource-allocation graph over multi-unit resources. Each request which cannot
+*	be granted adds a request edge and is checked for deadlock incrementally; alternatively, requests are admitted
+*	with the Banker's algorithm so that no deadlock can form.
+*	@date Friday, April 27, 2018
+*/
+
+//
+// Compiler Guards ////////////////////////
+//
+#ifndef DEADLOCKDETECTOR_H
+#define DEADLOCKDETECTOR_H
+
+//
+// Header Files ///////////////////////////
+//
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+//
+// Class Declaration ///////////////////////////
+//
+class DeadlockDetector {
+public:
+	// Deadlock handling modes
+	enum Mode {
+		NO_HANDLING,		// NONE: track the graph only
+		DETECTION,			// DETECT: fail a request which completes a deadlock
+		AVOIDANCE			// AVOID: grant a request only if the system stays in a safe state (Banker's algorithm)
+	};
+
+	// Constructor
+	DeadlockDetector();
+
+	// Initialization functions
+	void SetMode(std::string code) throw(std::logic_error);
+	void SetResources(const std::vector<std::string> &resourceNames, const std::vector<unsigned int> &resourceUnits);
+	void DeclareClaim(int processID, unsigned int resource, unsigned int units) throw(std::logic_error);
+
+	// Graph functions
+	bool CanGrant(int processID, unsigned int resource) throw(std::logic_error);
+	void Grant(int processID, unsigned int resource);
+	void Request(int processID, unsigned int resource) throw(std::logic_error);
+	void Withdraw(int processID);
+	void Release(int processID, unsigned int resource, unsigned int units);
+
+	// Accessors
+	Mode GetMode() const;
+
+private:
+	// A process node of the graph
+	struct Process {
+		Process() : waitingOn(-1), visited(0) {};
+
+		int waitingOn;						// Resource of the outstanding request edge, or -1
+		unsigned long visited;				// Search in which the node was last reached
+		std::vector<unsigned int> held;		// Assignment edges: units held of each resource
+		std::vector<unsigned int> claim;	// Maximum units of each resource the process may hold
+	};
+
+	// Private functions
+	Process& GetProcess(int processID);
+	bool IsSafe();
+	std::vector<int> FindDeadlock(int processID);
+
+	// Resources
+	std::vector<std::string> names;
+	std::vector<unsigned int> available;
+	std::vector<std::map<int, unsigned int> > holders;	// For each resource, the processes holding units of it
+
+	// Processes
+	std::vector<Process> processes;
+	unsigned long searches;								// Number of graph searches, to mark visited nodes
+
+	Mode mode;
+};
+
+#endif	// !DEADLOCKDETECTOR_H
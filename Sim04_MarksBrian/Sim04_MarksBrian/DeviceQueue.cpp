@@ -0,0 +1,234 @@
+/**
+*	@file DeviceQueue.cpp
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class implementation for a hard drive request queue with pluggable disk scheduling disciplines.
+*	@date Wednesday, April 25, 2018
+*/
+
+//
+// Header Files ///////////////////////////
+//
+#include "DeviceQueue.h"
+
+//
+// Class Function Definitions /////////////////
+//
+
+/**	Constructor
+*	\n Creates an empty first come, first served queue with the head resting on cylinder 0.
+*/
+DeviceQueue::DeviceQueue() {
+	discipline = FCFS;
+	merging = false;
+	cylinders = 0;
+	seekTime = 0;
+	nextSequence = 0;
+	head = 0;
+	sweepingUp = true;
+}
+
+/**	Set Discipline
+*	\n Translates the "Disk Scheduling Code" from the config file into a queueing discipline.
+*	@pre The queue must be empty.
+*	@param code is FCFS, SSTF, SCAN, or CSCAN
+*	@throw the code is not a known discipline
+*/
+void DeviceQueue::SetDiscipline(std::string code) throw(std::logic_error) {
+	if (code == "FCFS") {
+		discipline = FCFS;
+	}
+	else if (code == "SSTF") {
+		discipline = SSTF;
+	}
+	else if (code == "SCAN") {
+		discipline = SCAN;
+	}
+	else if (code == "CSCAN") {
+		discipline = CSCAN;
+	}
+	else {
+		throw std::logic_error("Disk scheduling code is either incompatible or undefined; check configuration file.");
+	}
+}
+
+/**	Set Merging
+*	\n Enables or disables merging of requests on adjacent cylinders into a single batch.
+*	@param merge is true to merge adjacent requests
+*/
+void DeviceQueue::SetMerging(bool merge) {
+	merging = merge;
+}
+
+/**	Set Geometry
+*	\n Sets the number of cylinders on the drive and the cost of moving the head.
+*	@param cylinderCount is the number of cylinders, or 0 if requests may name any cylinder
+*	@param seekTimePerCylinder is the time (us) to move the head across one cylinder
+*/
+void DeviceQueue::SetGeometry(int cylinderCount, long seekTimePerCylinder) {
+	cylinders = cylinderCount;
+	seekTime = seekTimePerCylinder;
+}
+
+/**	Push
+*	\n Adds a request to the queue.
+*	@param request is the request being queued
+*	@throw the request names a cylinder which the drive does not have
+*/
+void DeviceQueue::Push(Request request) throw(std::logic_error) {
+	if (request.cylinder < 0 || (cylinders > 0 && request.cylinder >= cylinders)) {
+		throw std::logic_error("Hard drive cylinder is outside of the drive; check Meta-Data file.");
+	}
+
+	request.sequence = nextSequence++;
+	if (discipline == FCFS) {
+		arrivals.push_back(request);
+	}
+	else {
+		byCylinder.insert(std::make_pair(request.cylinder, request));
+	}
+}
+
+/**	Dispatch
+*	\n Removes the next request from the queue according to the discipline. When merging is enabled, every pending
+*	request on a cylinder adjacent to the batch is serviced along with it, paying for a single sweep of the head.
+*	@pre The queue must not be empty.
+*	@return the batch of requests to service, along with its total service time
+*	@throw the queue is empty
+*/
+DeviceQueue::Batch DeviceQueue::Dispatch() throw(std::logic_error) {
+	if (Empty()) {
+		throw std::logic_error("Cannot dispatch from an empty device queue.");
+	}
+
+	Batch batch;
+	long travel = 0;
+	int low, high;
+
+	// Take the request chosen by the discipline
+	if (discipline == FCFS) {
+		batch.requests.push_back(arrivals.front());
+		arrivals.pop_front();
+	}
+	else {
+		std::multimap<int, Request>::iterator next = NextByCylinder(travel);
+		batch.requests.push_back(next->second);
+		byCylinder.erase(next);
+	}
+	low = high = batch.requests[0].cylinder;
+
+	// Absorb requests on adjacent cylinders, widening the batch until no neighbour remains
+	if (merging && discipline == FCFS) {
+		bool absorbed = true;
+		while (absorbed) {
+			absorbed = false;
+			for (std::deque<Request>::iterator it = arrivals.begin(); it != arrivals.end(); ) {
+				if (it->cylinder >= low - 1 && it->cylinder <= high + 1) {
+					low = (it->cylinder < low ? it->cylinder : low);
+					high = (it->cylinder > high ? it->cylinder : high);
+					batch.requests.push_back(*it);
+					it = arrivals.erase(it);
+					absorbed = true;
+				}
+				else {
+					++it;
+				}
+			}
+		}
+	}
+	else if (merging) {
+		std::multimap<int, Request>::iterator it = byCylinder.lower_bound(low - 1);
+		while (it != byCylinder.end() && it->first <= high + 1) {
+			low = (it->first < low ? it->first : low);
+			high = (it->first > high ? it->first : high);
+			batch.requests.push_back(it->second);
+			byCylinder.erase(it);
+			it = byCylinder.lower_bound(low - 1);
+		}
+	}
+
+	// Move the head to the nearer end of the batch, then sweep across it
+	int toLow = (head > low ? head - low : low - head);
+	int toHigh = (head > high ? head - high : high - head);
+	travel += (toLow < toHigh ? toLow : toHigh) + (high - low);
+	head = (toLow <= toHigh ? high : low);
+
+	batch.cylinder = batch.requests[0].cylinder;
+	batch.serviceTime = travel * seekTime;
+	for (unsigned int i = 0; i < batch.requests.size(); i++) {
+		batch.serviceTime += batch.requests[i].serviceTime;
+	}
+
+	return batch;
+}
+
+/**	Empty
+*	\n Checks for pending requests.
+*	@return true if there are no pending requests
+*/
+bool DeviceQueue::Empty() const {
+	return arrivals.empty() && byCylinder.empty();
+}
+
+/**	Size
+*	\n Getter function for the number of pending requests.
+*	@return the number of pending requests
+*/
+unsigned int DeviceQueue::Size() const {
+	return arrivals.size() + byCylinder.size();
+}
+
+/**	Get Head
+*	\n Getter function for the cylinder the head is resting on.
+*	@return the cylinder the head is resting on
+*/
+int DeviceQueue::GetHead() const {
+	return head;
+}
+
+/**	Next By Cylinder
+*	\n Finds the next request for the cylinder ordered disciplines. SCAN reverses at the last pending request in
+*	each direction; CSCAN returns to cylinder 0 once no request remains above the head.
+*	@param travel is increased by any head movement (in cylinders) not accounted for by the batch itself
+*	@return the next request to service
+*/
+std::multimap<int, DeviceQueue::Request>::iterator DeviceQueue::NextByCylinder(long &travel) {
+	std::multimap<int, Request>::iterator above = byCylinder.lower_bound(head);
+
+	if (discipline == SSTF) {
+		if (above == byCylinder.begin()) {
+			return above;
+		}
+		std::multimap<int, Request>::iterator below = above;
+		--below;
+		if (above == byCylinder.end() || (head - below->first) < (above->first - head)) {
+			return below;
+		}
+		return above;
+	}
+
+	if (discipline == CSCAN) {
+		if (above == byCylinder.end()) {
+			// Finish the sweep to the last cylinder, then return to cylinder 0
+			int last = (cylinders > 0 ? cylinders - 1 : head);
+			travel += (last - head) + last;
+			head = 0;
+			above = byCylinder.begin();
+		}
+		return above;
+	}
+
+	// SCAN
+	if (sweepingUp && above == byCylinder.end()) {
+		sweepingUp = false;
+	}
+	else if (!sweepingUp && (above == byCylinder.begin() && above->first > head)) {
+		sweepingUp = true;
+	}
+
+	if (sweepingUp) {
+		return above;
+	}
+	std::multimap<int, Request>::iterator below = byCylinder.upper_bound(head);
+	return --below;
+}
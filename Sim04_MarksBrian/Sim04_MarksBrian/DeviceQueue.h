@@ -0,0 +1,97 @@
+/**
+*	@file DeviceQueue.h
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class declaration for a request queue belonging to a single hard drive, which orders pending
+*	requests by a disk scheduling discipline and optionally merges adjacent requests into one batch.
+*	@date Wednesday, April 25, 2018
+*/
+
+//
+// Compiler Guards ////////////////////////
+//
+#ifndef DEVICEQUEUE_H
+#define DEVICEQUEUE_H
+
+//
+// Header Files ///////////////////////////
+//
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+//
+// Class Declaration ///////////////////////////
+//
+class DeviceQueue {
+public:
+	// Disk scheduling disciplines
+	enum Discipline {
+		FCFS,		// First come, first served
+		SSTF,		// Shortest seek time first
+		SCAN,		// Elevator: sweep up, then back down
+		CSCAN		// Circular elevator: sweep up, then return to cylinder 0
+	};
+
+	// A single pending request
+	struct Request {
+		Request() : processID(0), cylinder(0), serviceTime(0), sequence(0), queuedAt(0) {};
+		Request(int pid, int cyl, long time) : processID(pid), cylinder(cyl), serviceTime(time), sequence(0), queuedAt(0) {};
+
+		int processID;				// Process waiting on the request
+		std::string description;	// Device and direction of the request (e.g. "hard drive input"), for logging
+		int cylinder;				// Cylinder the request reads or writes
+		long serviceTime;			// Transfer time (us) of the request
+		unsigned long sequence;		// Arrival order of the request
+		long double queuedAt;		// Device time (us) at which the request joined the queue
+	};
+
+	// A set of requests serviced with a single positioning of the head
+	struct Batch {
+		Batch() : cylinder(0), serviceTime(0) {};
+
+		std::vector<Request> requests;
+		int cylinder;				// Cylinder the batch starts on
+		long serviceTime;			// Seek time plus transfer time (us) of every request in the batch
+	};
+
+	// Constructor
+	DeviceQueue();
+
+	// Initialization functions
+	void SetDiscipline(std::string code) throw(std::logic_error);
+	void SetMerging(bool merge);
+	void SetGeometry(int cylinderCount, long seekTimePerCylinder);
+
+	// Queue functions
+	void Push(Request request) throw(std::logic_error);
+	Batch Dispatch() throw(std::logic_error);
+
+	// Accessors
+	bool Empty() const;
+	unsigned int Size() const;
+	int GetHead() const;
+
+private:
+	// Private functions
+	std::multimap<int, Request>::iterator NextByCylinder(long &travel);
+
+	// Queue configuration
+	Discipline discipline;
+	bool merging;
+	int cylinders;
+	long seekTime;
+
+	// Pending requests; FCFS uses arrival order, all other disciplines use cylinder order
+	std::deque<Request> arrivals;
+	std::multimap<int, Request> byCylinder;
+	unsigned long nextSequence;
+
+	// Head status
+	int head;
+	bool sweepingUp;
+};
+
+#endif	// !DEVICEQUEUE_H
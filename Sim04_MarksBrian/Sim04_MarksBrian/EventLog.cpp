@@ -0,0 +1,317 @@
+/**
+*	@file EventLog.cpp
+*	@author Brian Marks
+*	@version 1.1
+*	@details Class implementation for the binary event log.
+*	@date Monday, April 30, 2018
+*/
+
+//
+// Header Files ///////////////////////////
+//
+#include "EventLog.h"
+#include "Varint.h"
+#include <fstream>
+#include <iterator>
+
+//
+// Class Function Definitions /////////////////
+//
+
+/**	Constructor
+*	\n Creates an empty log.
+*/
+EventLog::EventLog() {
+	Clear();
+}
+
+/**	Append
+*	\n Adds an event to the log, writing any text it names which the log does not have yet.
+*	@param record is the event
+*/
+void EventLog::Append(const Record &record) {
+	uint64_t text = Intern(record.text);
+	uint64_t device = Intern(record.device);
+
+	// Timestamps of events logged from different threads may be slightly out of order
+	int64_t change = (int64_t)(record.time - lastTime);
+	lastTime = record.time;
+
+	WriteNumber(record.event);
+	WriteNumber(((uint64_t)change << 1) ^ (uint64_t)(change >> 63));
+	WriteNumber(record.cpu + 1);
+	WriteNumber(record.process);
+	WriteNumber(record.arg);
+	WriteNumber(text);
+	WriteNumber(device);
+}
+
+/**	Save
+*	\n Writes the log to a file.
+*	@param path is the file
+*	@throw the file cannot be written
+*/
+void EventLog::Save(const std::string &path) const throw(std::logic_error) {
+	std::ofstream fout(path.c_str(), std::ios::binary | std::ios::trunc);
+	fout.write(data.data(), data.size());
+	if (!fout.good()) {
+		throw std::logic_error("streamToFile(): Bad log file");
+	}
+}
+
+/**	Clear
+*	\n Empties the log, for another run.
+*/
+void EventLog::Clear() {
+	data = "SIMLOG";
+	WriteNumber(1);
+	pos = data.size();
+	lastTime = 0;
+	textIDs.clear();
+	texts.clear();
+}
+
+/**	Load
+*	\n Reads a log written by Save, to take its events with Next.
+*	@param path is the file
+*	@throw the file cannot be read, or is not an event log
+*/
+void EventLog::Load(const std::string &path) throw(std::logic_error) {
+	std::ifstream fin(path.c_str(), std::ios::binary);
+	if (!fin.good()) {
+		throw std::logic_error("Event log cannot be read.");
+	}
+	Clear();
+	data.assign((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+
+	pos = 6;
+	if (data.compare(0, 6, "SIMLOG") != 0 || ReadNumber() != 1) {
+		throw std::logic_error("Event log is not an event log, or is damaged.");
+	}
+}
+
+/**	Next
+*	\n Takes the next event of a loaded log.
+*	@param record receives the event; its texts belong to the log
+*	@return false if every event has been taken
+*	@throw the log is damaged
+*/
+bool EventLog::Next(Record &record) throw(std::logic_error) {
+	uint64_t event;
+	for (;;) {
+		if (pos >= data.size()) {
+			return false;
+		}
+		event = ReadNumber();
+		if (event != textDefinition) {
+			break;
+		}
+		uint64_t length = ReadNumber();
+		if (length > data.size() - pos) {
+			throw std::logic_error("Event log is not an event log, or is damaged.");
+		}
+		texts.push_back(data.substr(pos, length));
+		pos += length;
+	}
+	if (event >= EVENT_COUNT) {
+		throw std::logic_error("Event log is not an event log, or is damaged.");
+	}
+
+	uint64_t change = ReadNumber();
+	lastTime += (uint64_t)((int64_t)(change >> 1) ^ -(int64_t)(change & 1));
+
+	record.event = (Event)event;
+	record.time = lastTime;
+	record.cpu = (int)ReadNumber() - 1;
+	record.process = (unsigned int)ReadNumber();
+	record.arg = ReadNumber();
+	record.text = Lookup(ReadNumber());
+	record.device = Lookup(ReadNumber());
+	return true;
+}
+
+/**	Render
+*	\n Formats an event as the line the text log has for it. The line is built in place from integer microseconds,
+*	with the digits written by hand, so it reuses the line's storage and matches the iostream formatting it replaced.
+*	@param record is the event
+*	@param line receives the line, without a newline; its storage is kept between calls
+*/
+void EventLog::Render(const Record &record, std::string &line) {
+	line.clear();
+	if (record.event == PLAIN) {
+		AppendText(line, record.text);
+		return;
+	}
+
+	// Timestamp: seconds, to the microsecond
+	AppendNumber(line, record.time / 1000000);
+	line.push_back('.');
+	AppendNumber(line, record.time % 1000000, 6);
+	line.append(" - ", 3);
+
+	switch (record.event) {
+		case TEXT:
+			break;
+		case PREPARING:
+			line.append("OS: preparing process ", 22);
+			AppendNumber(line, record.process + 1);
+			return;
+		case STARTING:
+		case RESUMING:
+			line.append(record.event == STARTING ? "OS: starting process " : "OS: resuming process ", 21);
+			AppendNumber(line, record.process + 1);
+			if (record.arg > 0) {
+				line.append(" on CPU ", 8);
+				AppendNumber(line, record.arg - 1);
+			}
+			return;
+		case REMOVING:
+			line.append("OS: removing process ", 21);
+			AppendNumber(line, record.process + 1);
+			return;
+		default:
+			line.append("Process ", 8);
+			AppendNumber(line, record.process + 1);
+			line.append(": ", 2);
+			break;
+	}
+
+	switch (record.event) {
+		case OPERATION_START:
+			line.append("start ", 6);
+			AppendText(line, record.text);
+			break;
+		case OPERATION_START_ON:
+			line.append("start ", 6);
+			AppendText(line, record.text);
+			line.append(" on ", 4);
+			AppendText(line, record.device);
+			line.push_back(' ');
+			AppendNumber(line, record.arg);
+			break;
+		case OPERATION_END:
+			line.append("end ", 4);
+			AppendText(line, record.text);
+			break;
+		case ADDRESS:
+			AppendText(line, record.text);
+			line.append("0x", 2);
+			AppendHex(line, record.arg, 8);
+			break;
+		default:
+			AppendText(line, record.text);
+			break;
+	}
+}
+
+/**	Append Text
+*	\n Appends a record's text to a line.
+*	@param line is the line
+*	@param text is the text, or NULL for none
+*/
+void EventLog::AppendText(std::string &line, const std::string* text) {
+	if (text != NULL) {
+		line.append(*text);
+	}
+}
+
+/**	Append Number
+*	\n Appends a number in decimal to a line, as std::to_string would, padded with leading zeros to a width.
+*	@param line is the line
+*	@param value is the number
+*	@param width is the fewest digits to write
+*/
+void EventLog::AppendNumber(std::string &line, uint64_t value, unsigned int width) {
+	char digits[20];
+	unsigned int count = 0;
+	do {
+		digits[sizeof(digits) - ++count] = (char)('0' + value % 10);
+		value /= 10;
+	} while (value > 0);
+
+	if (count < width) {
+		line.append(width - count, '0');
+	}
+	line.append(digits + sizeof(digits) - count, count);
+}
+
+/**	Append Hex
+*	\n Appends a number in lowercase hexadecimal to a line, padded with leading zeros to a width, as std::hex with
+*	std::setfill('0') and std::setw would.
+*	@param line is the line
+*	@param value is the number
+*	@param width is the fewest digits to write
+*/
+void EventLog::AppendHex(std::string &line, uint64_t value, unsigned int width) {
+	static const char hex[] = "0123456789abcdef";
+	char digits[16];
+	unsigned int count = 0;
+	do {
+		digits[sizeof(digits) - ++count] = hex[value & 0xF];
+		value >>= 4;
+	} while (value > 0);
+
+	if (count < width) {
+		line.append(width - count, '0');
+	}
+	line.append(digits + sizeof(digits) - count, count);
+}
+
+/**	Intern
+*	\n Numbers a text for the records naming it, writing its definition the first time it is named.
+*	@param text is the text, or NULL
+*	@return 1 + the text's number, or 0 for no text
+*/
+uint64_t EventLog::Intern(const std::string* text) {
+	if (text == NULL) {
+		return 0;
+	}
+
+	std::unordered_map<std::string, uint64_t>::const_iterator found = textIDs.find(*text);
+	if (found != textIDs.end()) {
+		return found->second;
+	}
+	uint64_t id = textIDs.size() + 1;
+	textIDs[*text] = id;
+	WriteNumber(textDefinition);
+	WriteNumber(text->size());
+	data += *text;
+	return id;
+}
+
+/**	Lookup
+*	\n Finds a text defined earlier in a loaded log.
+*	@param id is 1 + the text's number, or 0 for no text
+*	@return the text, or NULL
+*	@throw the text has not been defined
+*/
+const std::string* EventLog::Lookup(uint64_t id) const throw(std::logic_error) {
+	if (id == 0) {
+		return NULL;
+	}
+	if (id > texts.size()) {
+		throw std::logic_error("Event log is not an event log, or is damaged.");
+	}
+	return &texts[id - 1];
+}
+
+/**	Write Number
+*	\n Appends a number to the log as a variable-length integer.
+*	@param value is the number
+*/
+void EventLog::WriteNumber(uint64_t value) {
+	Varint::Write(data, value);
+}
+
+/**	Read Number
+*	\n Reads a variable-length integer written by WriteNumber.
+*	@return the number
+*	@throw the log ends within the number, or the number has more than 64 bits
+*/
+uint64_t EventLog::ReadNumber() throw(std::logic_error) {
+	uint64_t value;
+	if (!Varint::Read(data, pos, value)) {
+		throw std::logic_error("Event log is not an event log, or is damaged.");
+	}
+	return value;
+}
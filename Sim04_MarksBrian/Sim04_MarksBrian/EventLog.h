@@ -0,0 +1,98 @@
+/**
+*	@file EventLog.h
+*	@author Brian Marks
+*	@version 1.1
+*	@details Class declaration for the binary event log. Each logged event is kept as a record of its timestamp, the
+*	CPU it was logged from, its process, its type, the device it names and an address or other argument, rather than
+*	as a line of text. Records are written as variable-length integers, each timestamp as the change from the one
+*	before it, and each text (an operation, a device label, a report) is written once and named by number after.
+*	Rendering a record gives the exact line the text log has for it; the simlog tool renders a saved log.
+*	@note 1.1 update renders lines without iostreams, writing the digits of timestamps and addresses by hand
+*	@date Monday, April 30, 2018
+*/
+
+//
+// Compiler Guards ////////////////////////
+//
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+//
+// Header Files ///////////////////////////
+//
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <stdexcept>
+#include <stdint.h>
+
+//
+// Class Declaration ///////////////////////////
+//
+class EventLog {
+public:
+	// Types of event, and the lines they render as
+	enum Event {
+		TEXT,					// (ts) - (text)
+		PLAIN,					// (text), without a timestamp
+		PROCESS_TEXT,			// (ts) - Process (pid): (text)
+		PREPARING,				// (ts) - OS: preparing process (pid)
+		STARTING,				// (ts) - OS: starting process (pid)[ on CPU (arg - 1)]
+		RESUMING,				// (ts) - OS: resuming process (pid)[ on CPU (arg - 1)]
+		REMOVING,				// (ts) - OS: removing process (pid)
+		OPERATION_START,		// (ts) - Process (pid): start (text)
+		OPERATION_START_ON,		// (ts) - Process (pid): start (text) on (device) (arg)
+		OPERATION_END,			// (ts) - Process (pid): end (text)
+		ADDRESS,				// (ts) - Process (pid): (text)0x(arg, as eight or more hex digits)
+		EVENT_COUNT
+	};
+
+	// A logged event; the texts are not owned by the record
+	struct Record {
+		Record() : event(TEXT), time(0), cpu(-1), process(0), arg(0), text(NULL), device(NULL) {};
+
+		Event event;
+		uint64_t time;				// Microseconds since the log was started
+		int cpu;					// CPU the event was logged from, or -1
+		unsigned int process;		// Index of the process, from 0
+		uint64_t arg;				// Address, unit, or 1 + CPU, as the event says
+		const std::string* text;
+		const std::string* device;	// Label of the device class
+	};
+
+	// Constructor
+	EventLog();
+
+	// Writing functions
+	void Append(const Record &record);
+	void Save(const std::string &path) const throw(std::logic_error);
+	void Clear();
+
+	// Reading functions
+	void Load(const std::string &path) throw(std::logic_error);
+	bool Next(Record &record) throw(std::logic_error);
+
+	// Rendering
+	static void Render(const Record &record, std::string &line);
+	static void AppendNumber(std::string &line, uint64_t value, unsigned int width = 1);
+	static void AppendHex(std::string &line, uint64_t value, unsigned int width = 1);
+
+private:
+	// Private functions
+	static void AppendText(std::string &line, const std::string* text);
+	uint64_t Intern(const std::string* text);
+	const std::string* Lookup(uint64_t id) const throw(std::logic_error);
+	void WriteNumber(uint64_t value);
+	uint64_t ReadNumber() throw(std::logic_error);
+
+	// Record type which defines the next text, in place of an event
+	static const uint64_t textDefinition = 0x7F;
+
+	std::string data;										// The file: header, then records
+	size_t pos;												// While reading, the next record
+	uint64_t lastTime;										// Timestamp of the previous record
+	std::unordered_map<std::string, uint64_t> textIDs;		// While writing, the number of each text written
+	std::deque<std::string> texts;							// While reading, each text by number
+};
+
+#endif	// !EVENTLOG_H
@@ -0,0 +1,240 @@
+/**
+*	@file Executor.cpp
+*	@author Brian Marks
+*	@version 1.2
+*	@details Class implementation for a single-threaded executor which drives process state machines in virtual time.
+*	@note 1.1 update dispatches to any number of simulated CPUs
+*	@note 1.2 update summarizes a run's makespan, turnaround and utilization
+*	@date Thursday, April 26, 2018
+*/
+
+//
+// Header Files ///////////////////////////
+//
+#include "Executor.h"
+
+//
+// Class Function Definitions /////////////////
+//
+
+/**	Constructor
+*	\n Creates an executor for a set of processes and the devices they share.
+*	@param processes is the set of processes to drive, passed by reference
+*	@param rm is the resource manager owning the devices, passed by reference
+*	@param cpuCount is the number of simulated CPUs (at least 1)
+*/
+Executor::Executor(std::vector<ProcessControlBlock> &processes, ResourceManager &rm, unsigned int cpuCount)
+	: processQueue(processes), resourceManager(rm), cpus(cpuCount > 0 ? cpuCount : 1) {
+	exited = 0;
+	turnaroundTotal = 0;
+	now = 0;
+}
+
+/**	Run
+*	\n Runs every process to completion in virtual time. Each process runs until it suspends; a process waiting on
+*	a processor keeps it, while a process waiting on I/O gives it to the next READY process. Idle CPUs take READY
+*	processes in CPU order. Log timestamps and device timings follow the simulated clock for the duration of the run.
+*	@param schedule is the order in which processes first become READY
+*	@throw no process can make progress, or a process failed
+*/
+void Executor::run(const std::vector<unsigned int> &schedule) throw(std::logic_error) {
+	readyQueue.assign(schedule.begin(), schedule.end());
+	logger.setVirtualClock(&now);
+	resourceManager.UseVirtualClock(&now);
+
+	try {
+		while (exited < processQueue.size()) {
+			bool progress = false;
+
+			for (unsigned int c = 0; c < cpus.size(); c++) {
+				if (cpus[c].running && !cpus[c].busy) {
+					Step(c);
+					progress = true;
+				}
+				else if (!cpus[c].running && !readyQueue.empty()) {
+					unsigned int next = readyQueue.front();
+					readyQueue.pop_front();
+					Dispatch(c, next);
+					progress = true;
+				}
+			}
+
+			if (!progress) {
+				Advance();
+			}
+		}
+	}
+	catch (std::exception&) {
+		logger.setCPU(-1);
+		logger.setVirtualClock(NULL);
+		resourceManager.UseVirtualClock(NULL);
+		throw;
+	}
+
+	// Leave the final simulated time on the log for the end of the simulation
+	logger.setCPU(-1);
+	resourceManager.UseVirtualClock(NULL);
+}
+
+/**	Report
+*	\n Logs the utilization of every CPU over the simulated run, so load imbalance can be seen.
+*	@pre run() must have completed.
+*/
+void Executor::report() {
+	for (unsigned int i = 0; i < cpus.size(); i++) {
+		std::ostringstream line;
+		line << "OS: CPU " << i << " utilization " << std::fixed << std::setprecision(1)
+			<< (now > 0 ? 100 * cpus[i].busyTime / now : 0) << "%";
+		logger.writeWithTimestamp(line.str());
+	}
+}
+
+/**	Get Time
+*	\n Getter function for the simulated time.
+*	@return the simulated time in microseconds
+*/
+long double Executor::getTime() const {
+	return now;
+}
+
+/**	Get Metrics
+*	\n Getter function for the summary of the run.
+*	@pre run() must have completed.
+*	@return the makespan, mean turnaround and mean CPU utilization of the run
+*/
+Executor::Metrics Executor::getMetrics() const {
+	Metrics metrics;
+	metrics.makespan = now;
+	if (!processQueue.empty()) {
+		metrics.meanTurnaround = turnaroundTotal / processQueue.size();
+	}
+	if (now > 0) {
+		for (unsigned int i = 0; i < cpus.size(); i++) {
+			metrics.utilization += cpus[i].busyTime;
+		}
+		metrics.utilization /= now * cpus.size();
+	}
+	return metrics;
+}
+
+/**	Dispatch
+*	\n Gives a CPU to a READY process.
+*	@param cpu is the index of the idle CPU
+*	@param next is the index of the process being dispatched
+*/
+void Executor::Dispatch(unsigned int cpu, unsigned int next) {
+	logger.setCPU(cpu);
+
+	if (processQueue[next].getState() == ProcessControlBlock::START) {
+		// Log: (ts) OS: Preparing Process (i)
+		logger.writeProcessEvent(EventLog::PREPARING, next);
+		processQueue[next].changeState(ProcessControlBlock::READY);
+
+		// Log: (ts) OS: Starting Process (i)
+		logger.writeProcessEvent(EventLog::STARTING, next, OnCPU(cpu));
+	}
+	else {
+		// Log: (ts) OS: Resuming Process (i)
+		logger.writeProcessEvent(EventLog::RESUMING, next, OnCPU(cpu));
+	}
+
+	processQueue[next].changeState(ProcessControlBlock::RUNNING);
+	cpus[cpu].current = next;
+	cpus[cpu].running = true;
+}
+
+/**	Step
+*	\n Resumes the process running on a CPU up to its next suspension point. Processes waiting on memory which the
+*	process released on the way, by an M{free} or by exiting, are made READY at once.
+*	@param cpu is the index of the CPU
+*/
+void Executor::Step(unsigned int cpu) {
+	CPU &state = cpus[cpu];
+	logger.setCPU(cpu);
+	ProcessControlBlock::Await step = processQueue[state.current].resume(resourceManager);
+
+	if (step.kind == ProcessControlBlock::Await::CPU) {
+		state.busy = true;
+		state.freeAt = now + step.duration;
+		state.busyTime += step.duration;
+	}
+	else if (step.kind == ProcessControlBlock::Await::IO) {
+		state.running = false;
+	}
+	else if (step.kind == ProcessControlBlock::Await::MEMORY) {
+		// The resource manager wakes the process when memory is released
+		state.running = false;
+	}
+	else {
+		// Log: (ts) OS: Removing Process (i)
+		logger.writeProcessEvent(EventLog::REMOVING, state.current);
+		processQueue[state.current].changeState(ProcessControlBlock::EXIT);
+		state.running = false;
+		exited++;
+		turnaroundTotal += now;
+	}
+
+	// Processes waiting on memory the process released retry their allocations
+	Wake();
+}
+
+/**	Advance
+*	\n Moves simulated time to the next event: the earliest end of a processor operation, or the next I/O
+*	completion. Processor operations win ties. Processes woken by I/O completions rejoin the back of the ready queue.
+*	@throw there is no event to advance to while processes remain
+*/
+void Executor::Advance() throw(std::logic_error) {
+	long double ioTime = 0;
+	bool ioPending = resourceManager.NextIOEvent(ioTime);
+
+	int earliest = -1;
+	for (unsigned int c = 0; c < cpus.size(); c++) {
+		if (cpus[c].busy && (earliest < 0 || cpus[c].freeAt < cpus[earliest].freeAt)) {
+			earliest = c;
+		}
+	}
+
+	if (earliest >= 0 && (!ioPending || cpus[earliest].freeAt <= ioTime)) {
+		CPU &state = cpus[earliest];
+		now = state.freeAt;
+		state.busy = false;
+		logger.setCPU(earliest);
+		processQueue[state.current].endOperation();
+		return;
+	}
+
+	if (!ioPending) {
+		if (resourceManager.GetMemoryWaiting() > 0) {
+			throw std::logic_error("Deadlock: every remaining process is waiting on memory held by the others.");
+		}
+		throw std::logic_error("No process is ready to run and no I/O is pending.");
+	}
+
+	now = ioTime;
+	logger.setCPU(-1);
+	resourceManager.CompleteIOUntil(now);
+	Wake();
+}
+
+/**	Wake
+*	\n Makes processes whose I/O has completed, or which were waiting on released memory, READY; they rejoin the
+*	back of the ready queue.
+*/
+void Executor::Wake() {
+	std::vector<int> completions;
+	resourceManager.TakeCompletions(completions);
+	for (unsigned int i = 0; i < completions.size(); i++) {
+		processQueue[completions[i]].changeState(ProcessControlBlock::READY);
+		readyQueue.push_back(completions[i]);
+	}
+}
+
+/**	On CPU
+*	\n Names the CPU a process is dispatched to, for log lines. None is named on a single CPU, so single-CPU
+*	logs are unchanged.
+*	@param cpu is the index of the CPU
+*	@return the CPU to name in a dispatch log line, or -1
+*/
+int Executor::OnCPU(unsigned int cpu) const {
+	return cpus.size() > 1 ? (int)cpu : -1;
+}
@@ -0,0 +1,93 @@
+/**
+*	@file Executor.h
+*	@author Brian Marks
+*	@version 1.2
+*	@details Class declaration for a single-threaded executor which drives process state machines in virtual time.
+*	No thread is created per process or per I/O request; time jumps from one event to the next.
+*	@note 1.1 update dispatches to any number of simulated CPUs
+*	@note 1.2 update summarizes a run's makespan, turnaround and utilization
+*	@date Thursday, April 26, 2018
+*/
+
+//
+// Compiler Guards ////////////////////////
+//
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+//
+// Header Files ///////////////////////////
+//
+#include <deque>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include "Log.h"
+#include "ProcessControlBlock.h"
+#include "ResourceManager.h"
+
+extern Log logger;
+
+//
+// Class Declaration ///////////////////////////
+//
+class Executor {
+public:
+	// Summary of a completed run, for comparing runs
+	struct Metrics {
+		Metrics() : makespan(0), meanTurnaround(0), utilization(0) {};
+
+		long double makespan;		// Simulated time (us) at which the last process exited
+		long double meanTurnaround;	// Mean simulated time (us) from the start to a process' exit
+		long double utilization;	// Mean fraction of the run the CPUs spent on processor operations
+	};
+
+	// Constructor
+	Executor(std::vector<ProcessControlBlock> &processes, ResourceManager &rm, unsigned int cpuCount);
+
+	// Simulator functions
+	void run(const std::vector<unsigned int> &schedule) throw(std::logic_error);
+	void report();
+
+	// Accessors
+	long double getTime() const;
+	Metrics getMetrics() const;
+
+private:
+	// Status of a simulated CPU
+	struct CPU {
+		CPU() : running(false), busy(false), current(0), freeAt(0), busyTime(0) {};
+
+		bool running;				// true while a process holds the CPU
+		bool busy;					// true while the running process is suspended on a processor operation
+		unsigned int current;		// Process holding the CPU
+		long double freeAt;			// Simulated time (us) at which the processor operation ends
+		long double busyTime;		// Simulated time (us) spent on processor operations
+	};
+
+	// Private functions
+	void Dispatch(unsigned int cpu, unsigned int next);
+	void Step(unsigned int cpu);
+	void Advance() throw(std::logic_error);
+	void Wake();
+	int OnCPU(unsigned int cpu) const;
+
+	// Processes and devices being driven
+	std::vector<ProcessControlBlock> &processQueue;
+	ResourceManager &resourceManager;
+
+	// Scheduling status
+	std::deque<unsigned int> readyQueue;
+	unsigned int exited;
+	long double turnaroundTotal;	// Sum of the exited processes' exit times (us); every process starts at time 0
+
+	// CPU status
+	std::vector<CPU> cpus;
+
+	// Simulated time (us)
+	long double now;
+};
+
+#endif	// !EXECUTOR_H
@@ -3,55 +3,99 @@
 /**	Constructor
 *	\n Creates a new mutex lock object
 */
-Lock::Lock(){
-	mutexLockState = false;
-	
-	
+Lock::Lock() : mutexLock(1, &mutexWaits){
+	memoryFree = NULL;
+}
+
+/**	Destructor
+*	\n Releases the semaphore locks
+*/
+Lock::~Lock(){
+	ClearLocks();
 }
 
 /**	Initialize Locks
 *	\n Initializes all of the semaphore locks used for the manageable resources. Locks are initially unlocked.
-*	@param All parameters are the quantities of the manageable resources for which the locks are being made.
+*	Device and memory waits are recorded by the resource manager, whose processes wait without holding a thread, so
+*	those semaphores do not record waits.
+*	@param devices are the names of the device classes, for reporting waits
+*	@param units are the number of units of each device class
+*	@param memoryBlocks is the number of memory blocks
 */
-void Lock::InitializeLocks(unsigned int projectors, unsigned int hardDrives, unsigned long memory, unsigned long blockSize){
-	// Initialize projector semaphore for each projector
-	for (unsigned int i = 0; i < projectors; i++) {
-		projectorLocks.push_back(false);
-	}
+void Lock::InitializeLocks(const std::vector<std::string> &devices, const std::vector<unsigned int> &units, unsigned long memoryBlocks){
+	// Resources may be re-initialized
+	ClearLocks();
+	mutexWaits.Clear();
+	memoryWaits.Clear();
 
-	// Initialize hard drive semaphore for each hard drive
-	for (unsigned int i = 0; i < hardDrives; i++) {
-		hardDriveLocks.push_back(false);
+	// Initialize a semaphore and wait histogram for each unit of each device
+	deviceNames = devices;
+	deviceLocks.resize(units.size());
+	deviceChannels.clear();
+	unsigned int channel = Trace::CHANNEL_COUNT;
+	for (unsigned int device = 0; device < units.size(); device++) {
+		deviceChannels.push_back(channel);
+		channel += units[device];
+		for (unsigned int i = 0; i < units[device]; i++) {
+			deviceLocks[device].push_back(new Semaphore(1));
+		}
+		deviceWaits.push_back(new WaitHistogram());
 	}
 
 	// Initialize memory block semaphores for each memory block
-	unsigned long numBlocks = memory / blockSize;
-	for (unsigned long i = 0; i < numBlocks; i++) {
-		memoryBlockLocks.push_back(false);
+	for (unsigned long i = 0; i < memoryBlocks; i++) {
+		memoryBlockLocks.push_back(new Semaphore(1));
 	}
+	memoryFree = new Semaphore(memoryBlocks);
+}
+
+/**	Lock Mutex
+*	\n Locks the mutex, blocking until it is free
+*/
+void Lock::LockMutex(){
+	trace.Acquire(mutexLock, Trace::MUTEX);
 }
 
 /**	Unlock
-*	\n Lock the mutex
+*	\n Unlocks the mutex
 */
 void Lock::UnlockMutex(){
-	mutexLockState = false;
+	mutexLock.Post();
+}
+
+/**	Lock Device
+*	\n Locks a specified device unit semaphore, blocking until the unit is free
+*	@param device specifies the device class
+*	@param index specifies the unit which is being allocated
+*/
+void Lock::LockDevice(const unsigned int device, const unsigned int index){
+	trace.Acquire(*deviceLocks[device][index], deviceChannels[device] + index);
+}
+
+/**	Unlock Device
+*	\n Unlocks a specified device unit semaphore
+*	@param device specifies the device class
+*	@param index specifies the unit which is being deallocated
+*/
+void Lock::UnlockDevice(const unsigned int device, const unsigned int index){
+	deviceLocks[device][index]->Post();
 }
 
-/**	Unlock Projector
-*	\n Unlocks a specified projector semaphore
-*	@param index specifies the projector which is being deallocated
+/**	Reserve Memory
+*	\n Reserves one memory block if any is free. The reserved block is then claimed with TryLockMemory.
+*	@return true if a block was reserved
 */
-void Lock::UnlockProjector(const unsigned int index){
-	projectorLocks[index] = false;
+bool Lock::ReserveMemory(){
+	return memoryFree->TryWait();
 }
 
-/**	Unlock Hard Drive
-*	\n Unlocks a specified hard drive semaphore
-*	@param index specifies the hard drive which is being deallocated
+/**	Try Lock Memory
+*	\n Locks a specified memory block semaphore if the block is free
+*	@param index specifies the memory block being checked
+*	@return true if the memory block was locked, false if it was already in use
 */
-void Lock::UnlockHardDrive(const unsigned int index){
-	hardDriveLocks[index] = false;
+bool Lock::TryLockMemory(const unsigned int index){
+	return memoryBlockLocks[index]->TryWait();
 }
 
 /**	Unlock Memory
@@ -59,52 +103,76 @@ void Lock::UnlockHardDrive(const unsigned int index){
 *	@param index specifies the memory block which is being deallocated
 */
 void Lock::UnlockMemory(const unsigned int index){
-	memoryBlockLocks[index] = false;
+	memoryBlockLocks[index]->Post();
+	memoryFree->Post();
 }
 
-/**	Test and Set Mutex
-*	\n Checks the state of the lock, then locks it
-*	@return true if the mutex was locked, false otherwise
+/**	Record Device Wait
+*	\n Records the time a request queued behind earlier requests on a unit of a device
+*	@param device specifies the device class
+*	@param microSeconds is the time the request waited
 */
-bool Lock::TestAndSetMutex(){
-	bool initialState = mutexLockState;
-	mutexLockState = true;
-	
-	return initialState;
+void Lock::RecordDeviceWait(const unsigned int device, long double microSeconds){
+	deviceWaits[device]->Record(microSeconds);
 }
 
-/**	Test and Set Projector
-*	\n Checks the state of the specified projector semaphore, then locks it
-*	@param index specifies the projector being checked
-*	@return true if the projector was locked, false otherwise
+/**	Record Memory Wait
+*	\n Records the time a process waited for a memory block to be released
+*	@param microSeconds is the time the process waited
 */
-bool Lock::TestAndSetProjector(const unsigned int index){
-	bool initialState = projectorLocks[index];
-	projectorLocks[index] = true;
-
-	return initialState;
+void Lock::RecordMemoryWait(long double microSeconds){
+	memoryWaits.Record(microSeconds);
 }
 
-/**	Test and Set Hard Drive
-*	\n Checks the state of the specified hard drive semaphore, then locks it
-*	@param index specifies the hard drive being checked
-*	@return true if the hard drive was locked, false otherwise
+/**	Report Waits
+*	\n Logs the wait-time histogram of every resource which was waited on, so it can be seen where processes queue.
 */
-bool Lock::TestAndSetHardDrive(const unsigned int index){
-	bool initialState = hardDriveLocks[index];
-	hardDriveLocks[index] = true;
+void Lock::ReportWaits(){
+	std::vector<const WaitHistogram*> histograms(1, &mutexWaits);
+	std::vector<std::string> names(1, "mutex");
+	histograms.insert(histograms.end(), deviceWaits.begin(), deviceWaits.end());
+	names.insert(names.end(), deviceNames.begin(), deviceNames.end());
+	histograms.push_back(&memoryWaits);
+	names.push_back("memory");
 
-	return initialState;
+	for (unsigned int i = 0; i < histograms.size(); i++) {
+		if (histograms[i]->GetCount() > 0) {
+			logger.writeWithTimestamp("OS: " + names[i] + " waits: " + histograms[i]->ToString());
+		}
+	}
 }
 
-/**	Test and Set Memory
-*	\n Checks the state of the specified memory block semaphore, then locks it
-*	@param index specifies the memory block being checked
-*	@return true if the memory block was locked, false otherwise
+/**	Get Channel Count
+*	\n Getter function for the number of traced locks: the trace's own, then one for each unit of each device class.
+*	@return the number of traced locks
+*/
+unsigned int Lock::GetChannelCount() const{
+	unsigned int channels = Trace::CHANNEL_COUNT;
+	for (unsigned int device = 0; device < deviceLocks.size(); device++) {
+		channels += deviceLocks[device].size();
+	}
+	return channels;
+}
+
+/**	Clear Locks
+*	\n Releases the resource semaphores. No thread may be waiting on them.
 */
-bool Lock::TestAndSetMemory(const unsigned int index){
-	bool initialState = memoryBlockLocks[index];
-	memoryBlockLocks[index] = true;
+void Lock::ClearLocks(){
+	for (unsigned int device = 0; device < deviceLocks.size(); device++) {
+		for (unsigned int i = 0; i < deviceLocks[device].size(); i++) {
+			delete deviceLocks[device][i];
+		}
+	}
+	for (unsigned int i = 0; i < deviceWaits.size(); i++) {
+		delete deviceWaits[i];
+	}
+	for (unsigned int i = 0; i < memoryBlockLocks.size(); i++) {
+		delete memoryBlockLocks[i];
+	}
+	delete memoryFree;
 
-	return initialState;
+	deviceLocks.clear();
+	deviceWaits.clear();
+	memoryBlockLocks.clear();
+	memoryFree = NULL;
 }
@@ -1,10 +1,13 @@
 /**
 *	@file Lock
 *	@author Brian Marks
-*	@version 1.4
+*	@version 1.7
 *	@details Class declaration for a set of mutex and semaphore locks which work with pthreads
 *	@date Wednesday, April 18, 2018
 *	@note 1.4 update added semaphore functionality for each manageable resource
+*	@note 1.5 update replaced the test-and-set flags with blocking FIFO semaphores and added wait-time histograms
+*	@note 1.6 update replaced the projector and hard drive locks with locks for every unit of every device class
+*	@note 1.7 update acquires the mutex and device unit locks through the trace, so real-time runs can be replayed
 */
 
 //
@@ -17,39 +20,64 @@
 // Header Files /////////////////////////////
 //
 #include "Config.h"
+#include "Log.h"
+#include "Semaphore.h"
+#include "Trace.h"
+#include "WaitHistogram.h"
 #include <vector>
+#include <atomic>
 
 extern Config conf;
+extern Log logger;
+extern Trace trace;
 
 //
 // Class Declaration ///////////////////////////
 //
 class Lock{
 public:
-	// Constructor
+	// Constructor/Destructor
 	Lock();
+	~Lock();
 
 	// Initializer
-	void InitializeLocks(unsigned int projectors, unsigned int hardDrives, unsigned long memory, unsigned long blockSize);
+	void InitializeLocks(const std::vector<std::string> &devices, const std::vector<unsigned int> &units, unsigned long memoryBlocks);
 
 	// Status functions
+	void LockMutex();
 	void UnlockMutex();
-	void UnlockProjector(const unsigned int index);
-	void UnlockHardDrive(const unsigned int index);
+	void LockDevice(const unsigned int device, const unsigned int index);
+	void UnlockDevice(const unsigned int device, const unsigned int index);
+	bool ReserveMemory();
+	bool TryLockMemory(const unsigned int index);
 	void UnlockMemory(const unsigned int index);
-	bool TestAndSetMutex();
-	bool TestAndSetProjector(const unsigned int index);
-	bool TestAndSetHardDrive(const unsigned int index);
-	bool TestAndSetMemory(const unsigned int index);
+
+	// Trace functions
+	unsigned int GetChannelCount() const;
+
+	// Wait time functions
+	void RecordDeviceWait(const unsigned int device, long double microSeconds);
+	void RecordMemoryWait(long double microSeconds);
+	void ReportWaits();
 
 private:
+	// Releases the resource semaphores
+	void ClearLocks();
+
+	// Wait time histograms, one per resource
+	WaitHistogram mutexWaits;
+	std::vector<WaitHistogram*> deviceWaits;	// One per device class
+	WaitHistogram memoryWaits;
+
 	// Mutex Lock
-	bool mutexLockState;
+	Semaphore mutexLock;
 
 	// Semaphore Locks
-	std::vector<bool> projectorLocks;
-	std::vector<bool> hardDriveLocks;
-	std::vector<bool> memoryBlockLocks;
+	std::vector<std::string> deviceNames;
+	std::vector<std::vector<Semaphore*> > deviceLocks;	// One per unit of each device class
+	std::vector<unsigned int> deviceChannels;	// Traced lock of the first unit of each device class
+	std::vector<Semaphore*> memoryBlockLocks;
+	Semaphore* memoryFree;						// Counts the memory blocks which are not allocated
 
 };
 
@@ -1,10 +1,35 @@
 #include "Log.h"
+#include "Profiler.h"
+#include <cmath>
+
+// No thread simulates a CPU until it says so
+thread_local int Log::currentCPU = -1;
+
+// Each thread renders its lines into its own buffer, which keeps its storage from line to line
+thread_local std::string Log::lineBuffer;
+
 /** Default Log constructor
 *	\n Creates a new log
 */
 Log::Log(){
+	pthread_mutex_init(&logMutex, NULL);
+	virtualClock = NULL;
+	initialized = false;
 	logToMonitor = false;
 	logToFile = false;
+	logToBinary = false;
+	levels = 0;
+	sampleRate = 1;
+	sampleCount = 0;
+}
+
+/** Destructor
+*	\n Releases the per-CPU logs.
+*/
+Log::~Log(){
+	for (unsigned int i = 0; i < cpuStreams.size(); i++) {
+		delete cpuStreams[i];
+	}
 }
 
 /**	Initialize Log Settings
@@ -20,55 +45,137 @@ void Log::initializeLogSettings(){
 		logToMonitor = true;
 		logToFile = true;
 	}
+	else if (conf.logSetting == "Binary") {
+		logToBinary = true;
+	}
+	else if (conf.logSetting == "None") {
+		// Batch runs are summarized rather than logged
+	}
 	else {
 		logToFile = true;
 	}
 
-	// start log timer
+	// Levels and sampling; nothing is formatted when nothing is written
+	levels = (conf.logSetting == "None" ? 0 : conf.logLevels);
+	sampleRate = conf.logSampleRate;
+	sampleCount = 0;
+	sampled.clear();
+
+	// start log timer, restarting it if the log is initialized again for another run
+	if (initialized) {
+		logTimer.stop();
+	}
 	logTimer.start();
 
 	// set initialized
 	initialized = true;
 }
 
+/**	Set Virtual Clock
+*	\n Timestamps log entries with simulated time rather than elapsed real time.
+*	@param clock points to the simulated time in microseconds, or NULL to return to real time
+*/
+void Log::setVirtualClock(const long double* clock){
+	virtualClock = clock;
+}
+
+/**	Set CPU
+*	\n Attributes the calling thread's following log entries to a simulated CPU, for the per-CPU logs.
+*	@param cpu is the CPU being simulated, or -1 for none
+*/
+void Log::setCPU(int cpu){
+	currentCPU = cpu;
+}
+
+/**	Enable Per-CPU Logs
+*	\n Keeps a separate log for each simulated CPU alongside the full log, when logging to file.
+*	@param cpus is the number of simulated CPUs
+*/
+void Log::enablePerCPULogs(unsigned int cpus){
+	for (unsigned int i = cpuStreams.size(); i < cpus; i++) {
+		cpuStreams.push_back(new std::ostringstream());
+	}
+}
+
+/**	Set Process Count
+*	\n Tracks the sampling decision of each process' current operation. Must be called before any process runs.
+*	@param processes is the number of processes
+*/
+void Log::setProcessCount(unsigned int processes){
+	sampled.assign(processes, 1);
+}
+
+/**	Sample Operation
+*	\n Decides whether a process' next operation is logged, for its operation and resource lines. The decision
+*	stands until the process starts another operation, however many threads log the lines of this one.
+*	@param processID is the process starting an operation, from 0
+*/
+void Log::sampleOperation(int processID){
+	if (sampleRate > 1 && processID >= 0 && (unsigned int)processID < sampled.size()) {
+		sampled[processID] = (sampleCount++ % sampleRate == 0);
+	}
+}
+
 /**	Write to Log
 *	\n Logs a simple message.
 *	@param log is the string message to be output
 */
 void Log::writeToLog(std::string log){
-	if (logToMonitor) {
-		std::cout << log << std::endl;
+	EventLog::Record record;
+	record.event = EventLog::PLAIN;
+	record.text = &log;
+	emit(record);
+}
+
+/**	Emit Record
+*	\n Keeps an event in the binary event log, or writes the line it renders as.
+*	@param record is the event; it is attributed to the CPU it was logged from
+*/
+void Log::emit(EventLog::Record &record){
+	if (logToBinary) {
+		PROFILE_ZONE("log");
+		record.cpu = currentCPU;
+		trace.Acquire(&logMutex, Trace::LOG);
+		events.Append(record);
+		pthread_mutex_unlock(&logMutex);
+		return;
 	}
-	if (logToFile) {
-		outstream << log << std::endl;
+
+	if (lineBuffer.capacity() < 256) {
+		lineBuffer.reserve(256);
 	}
+	EventLog::Render(record, lineBuffer);
+	emitLine(lineBuffer);
 }
 
-/**	Write to Log with Timestamp
-*	\n Logs a simple message with a timestamp, precise down to ms.
-*	@param log is the string message to be output
+/**	Emit Line
+*	\n Writes a formatted line to the monitor and/or file log, and to the log of the CPU it was written from.
+*	@param line is the formatted line, without a newline
 */
-void Log::writeWithTimestamp(std::string log){
+void Log::emitLine(const std::string &line){
+	PROFILE_ZONE("log");
+	trace.Acquire(&logMutex, Trace::LOG);
 	if (logToMonitor) {
-		std::cout << std::fixed << std::setprecision(6) << logTimer.getElapsedSeconds() << " - " << log << std::endl;
+		std::cout << line << std::endl;
 	}
 	if (logToFile) {
-		outstream << std::fixed << std::setprecision(6) << logTimer.getElapsedSeconds() << " - " << log << std::endl;
+		outstream.write(line.data(), line.size()).put('\n');
+		if (currentCPU >= 0 && (unsigned int)currentCPU < cpuStreams.size()) {
+			cpuStreams[currentCPU]->write(line.data(), line.size()).put('\n');
+		}
 	}
+	pthread_mutex_unlock(&logMutex);
 }
 
-/**	Write to Log with Address
-*	\n Logs a simple message, followed by a number representing a memory address in hexadecimal.
-*	@param log is the string message to be output
-*	@param address is the long which will be converted to hex. This represents a memory address.
+/**	Get Timestamp
+*	\n Getter function for the time at which an entry is being logged.
+*	@return the microseconds elapsed since the log was initialized, in real or simulated time
 */
-void Log::writeWithAddress(std::string log, long address){
-	if (logToMonitor) {
-		std::cout << std::fixed << std::setprecision(6) << logTimer.getElapsedSeconds() << " - " << log << std::setfill('0') << std::setw(8) << std::hex << address << std::endl;
-	}
-	if (logToFile) {
-		outstream << std::fixed << std::setprecision(6) << logTimer.getElapsedSeconds() << " - " << log << std::setfill('0') << std::setw(8) << std::hex << address << std::endl;
+uint64_t Log::getTimestamp(){
+	if (virtualClock != NULL) {
+		return llroundl(*virtualClock);
 	}
+	return llroundl(logTimer.getElapsedMicroSeconds());
 }
 
 /**	Stream to File
@@ -79,6 +186,12 @@ void Log::writeWithAddress(std::string log, long address){
 void Log::streamToFile() throw(std::logic_error) {
 		std::ofstream fout;
 
+		// The binary event log holds every CPU's events; simlog renders the per-CPU logs from it
+		if (logToBinary) {
+			events.Save(conf.logPath);
+			return;
+		}
+
 		fout.open(conf.logPath.c_str(), std::ofstream::out);
 		if(fout.good()){
 			fout << outstream.str();
@@ -88,5 +201,15 @@ void Log::streamToFile() throw(std::logic_error) {
 		else {
 			throw std::logic_error("streamToFile(): Bad log file");
 		}
+
+		// Per-CPU logs
+		for (unsigned int i = 0; i < cpuStreams.size(); i++) {
+			fout.open((conf.logPath + ".cpu" + std::to_string(i)).c_str(), std::ofstream::out);
+			if (!fout.good()) {
+				throw std::logic_error("streamToFile(): Bad per-CPU log file");
+			}
+			fout << cpuStreams[i]->str();
+			fout.close();
+		}
 	
-}
\ No newline at end of file
+}
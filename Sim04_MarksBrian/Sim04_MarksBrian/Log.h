@@ -1,8 +1,12 @@
 /**
 *	@file Log.h
 *	@author Brian Marks
-*	@version 1.0
+*	@version 1.3
 *	@details Class declaration for the logger which will handle all console and file I/O
+*	@note 1.1 update logs events as records, which are rendered as text or kept in a binary event log
+*	@note 1.2 update logs only the configured levels, and samples the operation and resource levels by operation. Levels above
+*	SIM_LOG_MAX_LEVEL are compiled out: their write functions are inline and test the level first.
+*	@note 1.3 update renders each line into a buffer kept by the logging thread, without iostream formatting
 *	@date Monday, Feb. 26, 2018
 */
 
@@ -19,34 +23,228 @@
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <atomic>
+#include <vector>
+#include <pthread.h>
 #include "Config.h"
+#include "EventLog.h"
 #include "Timer.h"
+#include "Trace.h"
 
 extern Config conf;
+extern Trace trace;
+
+// The most detailed level of log line compiled in; build with -DSIM_LOG_MAX_LEVEL=0 to keep only the lifecycle
+#ifndef SIM_LOG_MAX_LEVEL
+#define SIM_LOG_MAX_LEVEL 3
+#endif
 
 //
 // Class Function Declarations ////////////
 //
 class Log {
 public:
+	// Levels of log line, from the least to the most detailed; Config::logLevels has a bit for each
+	enum Level {
+		LIFECYCLE,			// Processes being prepared, started, resumed and removed; the reports
+		OPERATION,			// Operations starting and ending
+		RESOURCE,			// Memory being allocated and freed
+		DEBUG,				// Work stealing and memory waits
+		LEVEL_COUNT
+	};
+
 	// Constructors
 	Log();
+	~Log();
 	
 	// Functions
 	void initializeLogSettings();
+	void setVirtualClock(const long double* clock);
+	void setCPU(int cpu);
+	void enablePerCPULogs(unsigned int cpus);
+	void setProcessCount(unsigned int processes);
+	void sampleOperation(int processID);
 	void writeToLog(std::string log);
-	void writeWithTimestamp(std::string log);
-	void writeWithAddress(std::string log, long address);
+	void writeWithTimestamp(std::string log, Level level = LIFECYCLE);
+	void writeProcessText(Level level, int processID, const std::string &text);
+	void writeProcessEvent(EventLog::Event event, int processID, int cpu = -1);
+	void writeOperation(EventLog::Event event, int processID, const std::string &operation);
+	void writeOperationOn(int processID, const std::string &operation, const std::string &device, unsigned int unit);
+	void writeWithAddress(int processID, const std::string &text, unsigned long address);
+
+	bool isEnabled(Level level) const;
 
 	void streamToFile() throw (std::logic_error);
 
 private:
+	bool isLogged(Level level, int processID = -1);
+	uint64_t getTimestamp();
+	void emit(EventLog::Record &record);
+	void emitLine(const std::string &line);
+
 	Timer logTimer;
+	const long double* virtualClock;		// Simulated time (us) used for timestamps instead of logTimer, if set
 
 	// Control data
-	bool initialized, logToMonitor, logToFile;
+	bool initialized, logToMonitor, logToFile, logToBinary;
 	std::ostringstream outstream;
+	EventLog events;				// The log, when it is kept as binary records
+	unsigned int levels;			// Bit n set to log Level n
+	unsigned int sampleRate;		// 1 in this many operations has its operation and resource lines logged
+	std::atomic<unsigned long> sampleCount;
+	std::vector<char> sampled;		// Whether the current operation of each process is logged
+	pthread_mutex_t logMutex;		// I/O threads log their completions concurrently with processes
+
+	// Per-CPU logs
+	std::vector<std::ostringstream*> cpuStreams;	// Lines logged while running on each CPU, written to (log path).cpu(N)
+	static thread_local int currentCPU;				// CPU the calling thread is simulating, or -1
+	static thread_local std::string lineBuffer;		// Line being rendered by the calling thread
 };
 
+/**	Is Enabled
+*	\n Checks whether lines of a level are logged, before doing work only those lines need.
+*	@param level is the level
+*	@return true if the level is compiled in and configured
+*/
+inline bool Log::isEnabled(Level level) const{
+	return level <= SIM_LOG_MAX_LEVEL && (levels & (1u << level)) != 0;
+}
+
+/**	Is Logged
+*	\n Decides whether a line of a level is logged: its level must be enabled, and operation and resource lines are
+*	sampled at the configured rate. The lines of a process follow the decision sampleOperation made for its current
+*	operation, so an operation logs all of its lines or none; lines of an untracked process are sampled one by one.
+*	@param level is the line's level
+*	@param processID is the process the line is about, from 0, or -1 for none
+*	@return true to log the line
+*/
+inline bool Log::isLogged(Level level, int processID){
+	if (!isEnabled(level)) {
+		return false;
+	}
+	if (sampleRate > 1 && (level == OPERATION || level == RESOURCE)) {
+		if (processID >= 0 && (unsigned int)processID < sampled.size()) {
+			return sampled[processID] != 0;
+		}
+		return sampleCount++ % sampleRate == 0;
+	}
+	return true;
+}
+
+/**	Write to Log with Timestamp
+*	\n Logs a simple message with a timestamp, precise down to ms.
+*	@param log is the string message to be output
+*	@param level is the level of the message
+*/
+inline void Log::writeWithTimestamp(std::string log, Level level){
+	if (!isLogged(level)) {
+		return;
+	}
+
+	EventLog::Record record;
+	record.event = EventLog::TEXT;
+	record.time = getTimestamp();
+	record.text = &log;
+	emit(record);
+}
+
+/**	Write Process Text
+*	\n Logs a message about a process: (ts) - Process (pid): (text)
+*	@param level is the level of the message
+*	@param processID is the process, from 0
+*	@param text is the message
+*/
+inline void Log::writeProcessText(Level level, int processID, const std::string &text){
+	if (!isLogged(level, processID)) {
+		return;
+	}
+
+	EventLog::Record record;
+	record.event = EventLog::PROCESS_TEXT;
+	record.time = getTimestamp();
+	record.process = processID;
+	record.text = &text;
+	emit(record);
+}
+
+/**	Write Process Event
+*	\n Logs the operating system preparing, starting, resuming or removing a process.
+*	@param event is PREPARING, STARTING, RESUMING or REMOVING
+*	@param processID is the process, from 0
+*	@param cpu is the CPU starting or resuming the process, or -1 to name none
+*/
+inline void Log::writeProcessEvent(EventLog::Event event, int processID, int cpu){
+	if (!isLogged(LIFECYCLE)) {
+		return;
+	}
+
+	EventLog::Record record;
+	record.event = event;
+	record.time = getTimestamp();
+	record.process = processID;
+	record.arg = cpu + 1;
+	emit(record);
+}
+
+/**	Write Operation
+*	\n Logs the start or end of an operation of a process: (ts) - Process (pid): start|end (operation)
+*	@param event is OPERATION_START or OPERATION_END
+*	@param processID is the process, from 0
+*	@param operation names the operation
+*/
+inline void Log::writeOperation(EventLog::Event event, int processID, const std::string &operation){
+	if (!isLogged(OPERATION, processID)) {
+		return;
+	}
+
+	EventLog::Record record;
+	record.event = event;
+	record.time = getTimestamp();
+	record.process = processID;
+	record.text = &operation;
+	emit(record);
+}
+
+/**	Write Operation On
+*	\n Logs the start of an operation on a unit of a device: (ts) - Process (pid): start (operation) on (device) (unit)
+*	@param processID is the process, from 0
+*	@param operation names the operation
+*	@param device is the label of the device class
+*	@param unit is the unit of the device
+*/
+inline void Log::writeOperationOn(int processID, const std::string &operation, const std::string &device, unsigned int unit){
+	if (!isLogged(OPERATION, processID)) {
+		return;
+	}
+
+	EventLog::Record record;
+	record.event = EventLog::OPERATION_START_ON;
+	record.time = getTimestamp();
+	record.process = processID;
+	record.arg = unit;
+	record.text = &operation;
+	record.device = &device;
+	emit(record);
+}
+
+/**	Write to Log with Address
+*	\n Logs a message about a process, followed by a memory address in hexadecimal: (ts) - Process (pid): (text)0x(address)
+*	@param processID is the process, from 0
+*	@param text is the message
+*	@param address is the memory address, written as at least eight hex digits
+*/
+inline void Log::writeWithAddress(int processID, const std::string &text, unsigned long address){
+	if (!isLogged(RESOURCE, processID)) {
+		return;
+	}
+
+	EventLog::Record record;
+	record.event = EventLog::ADDRESS;
+	record.time = getTimestamp();
+	record.process = processID;
+	record.arg = address;
+	record.text = &text;
+	emit(record);
+}
 
 #endif // !LOG_H
\ No newline at end of file
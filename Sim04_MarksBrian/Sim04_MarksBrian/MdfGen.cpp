@@ -0,0 +1,104 @@
+/**
+*	@file MdfGen.cpp
+*	@author Brian Marks
+*	@version 1.0
+*	@details Command line tool which writes a synthetic meta-data (.mdf) workload for scale testing the simulator.
+*	@date Monday, April 30, 2018
+*/
+
+//
+// Header Files ///////////////////////
+//
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include "WorkloadGenerator.h"
+
+//
+// Usage
+//
+static void usage() {
+	std::cerr << "Usage: mdfgen [options]\n"
+		<< "  -p count    number of applications (default 10)\n"
+		<< "  -n count    operations per application (default 10)\n"
+		<< "  -m P:I:O:M  weights of processor, input, output and memory operations (default 4:2:2:2)\n"
+		<< "  -c spec     cycle counts: uniform:low:high, zipf:exponent:low:high, or pareto:alpha:low:high (default uniform:1:10)\n"
+		<< "  -d weights  device weights, e.g. \"hard drive=3,keyboard=1,monitor=1\" (default all 1)\n"
+		<< "  -a prob     probability an I/O operation uses its application's home device (default 0)\n"
+		<< "  -y count    name a cylinder from 0 to count-1 on hard drive operations (default none)\n"
+		<< "  -f          free earlier allocations with M{free}\n"
+		<< "  -s seed     random seed (default 1)\n"
+		<< "  -o file     output file (default standard output)" << std::endl;
+	exit(1);
+}
+
+//
+// Main Function Implementation
+//
+int main(int argc, char* argv[]) {
+	WorkloadGenerator generator;
+	unsigned long processes = 10;
+	unsigned int operations = 10;
+	const char* outputName = NULL;
+	int option;
+
+	try {
+		while ((option = getopt(argc, argv, "p:n:m:c:d:a:y:fs:o:")) != -1) {
+			switch (option) {
+				case 'p':
+					processes = strtoul(optarg, NULL, 10);
+					break;
+				case 'n':
+					operations = strtoul(optarg, NULL, 10);
+					break;
+				case 'm':
+					generator.SetMix(optarg);
+					break;
+				case 'c':
+					generator.SetCycles(optarg);
+					break;
+				case 'd':
+					generator.SetDevices(optarg);
+					break;
+				case 'a':
+					generator.SetAffinity(atof(optarg));
+					break;
+				case 'y':
+					generator.SetCylinders(atoi(optarg));
+					break;
+				case 'f':
+					generator.SetFreeing(true);
+					break;
+				case 's':
+					generator.SetSeed(strtoull(optarg, NULL, 10));
+					break;
+				case 'o':
+					outputName = optarg;
+					break;
+				default:
+					usage();
+			}
+		}
+		if (optind != argc) {
+			usage();
+		}
+		generator.SetProcesses(processes, operations);
+
+		FILE* out = outputName ? fopen(outputName, "wb") : stdout;
+		if (out == NULL) {
+			throw std::logic_error("Output file could not be opened.");
+		}
+		generator.Write(out);
+		if ((outputName && fclose(out) != 0) || (!outputName && fflush(out) != 0)) {
+			throw std::logic_error("Workload could not be written.");
+		}
+	}
+	catch (std::logic_error &e) {
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
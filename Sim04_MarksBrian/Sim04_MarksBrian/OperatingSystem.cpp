@@ -1,7 +1,7 @@
 /**
 *	@file OperatingSystem.cpp
 *	@author Brian Marks
-*	@version 1.2
+*	@version 1.3
 *	@details Class implementation for a simulation of a running operating system
 *	@date Monday, Feb. 26, 2018
 */
@@ -10,6 +10,7 @@
 // Header Files ///////////////////////////
 //
 #include "OperatingSystem.h"
+#include "Profiler.h"
 
 //
 // OperatingSystem Class Function Implementations /////////
@@ -119,7 +120,8 @@ bool OperatingSystem::handleApplicationCode(MetaDataItem md) throw (std::logic_e
 *	@param newOp is a meta-data code block which is to be translated into an operation.
 */
 void OperatingSystem::addOperation(ProcessControlBlock &process, MetaDataItem newOp) {
-	Operation tempOp(newOp.code, newOp.descriptor, newOp.timeVal);
+	Operation tempOp(newOp.code, newOp.descriptor, newOp.timeVal, newOp.cylinder);
+	tempOp.pages = newOp.pages;
 	process.addOperation(tempOp);
 }
 
@@ -130,6 +132,7 @@ void OperatingSystem::addOperation(ProcessControlBlock &process, MetaDataItem ne
 *	@throw if the scheduling method cannot be determined, an error is thrown.
 */
 void OperatingSystem::scheduleProcesses() throw (std::logic_error){
+		PROFILE_ZONE("schedule");
 		// First in First Out
 		if (conf.schedule == "FIFO") {
 			for (unsigned int i = 0; i < processQueue.size(); i++) {
@@ -207,33 +210,74 @@ void OperatingSystem::runSimulation() throw (std::logic_error){
 
 		// Start timestamp timer
 		logger.initializeLogSettings();
+		logger.setProcessCount(processQueue.size());
 
 		// Log: (ts) Simulator Program Starting
 		logger.writeWithTimestamp("Simulator program starting");
 
-		// Loop through processes
-		for (unsigned int i = 0; i < processQueue.size(); i++) {
-			// Log: (ts) OS: Preparing Process (i)
-			logger.writeWithTimestamp("OS: preparing process " + std::to_string(processSchedule[i]+1));
-
-			setReady(processQueue[processSchedule[i]]);
+		// Pick up new cycle times while running when the config file changes or on SIGHUP
+		ConfigWatcher watcher;
+		if (conf.configReload == "ON") {
+			watcher.Start(conf);
+		}
 
-			// Log: (ts) OS: Starting Process (i)
-			logger.writeWithTimestamp("OS: starting process " + std::to_string(processSchedule[i]+1));
+		// Maximum claims for deadlock avoidance: memory blocks are held until a process exits; pages are never waited on
+		for (unsigned int i = 0; i < processQueue.size() && !resourceManager.IsPaging(); i++) {
+			resourceManager.DeclareMemoryClaim(i, processQueue[i].getMemoryClaim());
+		}
 
-			setRunning(processQueue[processSchedule[i]]);
+		// Each simulated CPU also keeps its own log
+		int cpuCount = conf.processorQuantity;
+		if (cpuCount < 1) {
+			throw std::logic_error("Processor quantity must be at least 1; check configuration file.");
+		}
+		if (cpuCount > 1) {
+			logger.enablePerCPULogs(cpuCount);
+		}
 
-			// Run Process
-			bool processOK = false;
-			processOK = processQueue[processSchedule[i]].run(resourceManager);
-			if (!processOK) {
-				std::cout << processSchedule[i] << " th " << std::endl;
-				throw std::logic_error("Process has failed to execute successfully.");
+		// Record and replay follow the interleaving of threads, which only real time has
+		std::string mode = conf.simulationMode;
+		if (conf.traceMode != "OFF") {
+			if (mode != "REAL") {
+				throw std::logic_error("Record and replay apply only to REAL simulation mode; check configuration file.");
+			}
+			if (conf.configReload == "ON") {
+				throw std::logic_error("Record and replay need configuration reload OFF; check configuration file.");
 			}
+		}
+
+		// Virtual time: one thread drives every process' state machine, jumping from event to event
+		if (mode == "VIRTUAL") {
+			Executor executor(processQueue, resourceManager, cpuCount);
+			executor.run(processSchedule);
+			executor.report();
+			runMetrics = executor.getMetrics();
+			lock.ReportWaits();
+			resourceManager.ReportPaging();
+
+			// Log: (ts) Simulator Program Ending
+			logger.writeWithTimestamp("Simulator program ending");
+			logger.setVirtualClock(NULL);
+			return;
+		}
+		else if (mode != "REAL") {
+			throw std::logic_error("Simulation mode code is either incompatible or undefined; check configuration file.");
+		}
 
-			// Log: (ts) OS: Removing Process (i)
-			logger.writeWithTimestamp("OS: removing process " + std::to_string(processSchedule[i]+1));
-			setExit(processQueue[processSchedule[i]]);
+		// Real time: each core runs on its own thread, stealing READY processes from busier cores
+		std::string affinityCode = conf.coreAffinity;
+		if (affinityCode != "ON" && affinityCode != "OFF") {
+			throw std::logic_error("Core affinity code must be ON or OFF; check configuration file.");
+		}
+		trace.Start(conf.traceMode, conf.tracePath, lock.GetChannelCount(), cpuCount);
+		WorkStealingScheduler scheduler(processQueue, resourceManager, cpuCount, affinityCode == "ON");
+		scheduler.run(processSchedule);
+		trace.Finish();
+		scheduler.report();
+		lock.ReportWaits();
+		resourceManager.ReportPaging();
+		if (!trace.Summary().empty()) {
+			logger.writeWithTimestamp("OS: " + trace.Summary());
 		}
 
 		// Log: (ts) Simulator Program Ending
@@ -245,18 +289,42 @@ void OperatingSystem::runSimulation() throw (std::logic_error){
 	}
 }
 
+/**	Reconfigure
+*	\n Applies the current configuration to the loaded processes before they run: the resources are initialized
+*	again and every process' random stream restarts from the configured seed. The meta-data is not read again.
+*	@throw the configuration's resources are invalid
+*/
+void OperatingSystem::reconfigure() throw (std::logic_error){
+	for (unsigned int i = 0; i < processQueue.size(); i++) {
+		processQueue[i].reseed(conf.randomSeed);
+	}
+	resourceManager.initializeResources();
+}
+
+/**	Get Run Metrics
+*	\n Getter function for the summary of the last run.
+*	@pre runSimulation() must have completed in virtual time.
+*	@return the makespan, mean turnaround and mean CPU utilization of the run
+*/
+Executor::Metrics OperatingSystem::getRunMetrics() const{
+	return runMetrics;
+}
+
 /** Set Ready
 *	\n Sets a process' status to READY
 *	@param process to be changed
 *	@throw there are rules for how a process can move from one state to another; this function tried to break one of them.
 */
-void OperatingSystem::setReady(ProcessControlBlock process) throw (std::logic_error){
+void OperatingSystem::setReady(ProcessControlBlock &process) throw (std::logic_error){
 	// Can move to READY from START, RUNNING, or WAITING
 	if (process.getState() == ProcessControlBlock::START ||
 			process.getState() == ProcessControlBlock::WAITING ||
 				process.getState() == ProcessControlBlock::RUNNING) {
 		process.changeState(ProcessControlBlock::READY);
 	}
+	else if (process.getState() == ProcessControlBlock::READY) {
+		return;
+	}
 	else {
 		throw std::logic_error("Invalid process state conversion to READY.");
 	}
@@ -267,7 +335,7 @@ void OperatingSystem::setReady(ProcessControlBlock process) throw (std::logic_er
 *	@param process to be changed
 *	@throw there are rules for how a process can move from one state to another; this function tried to break one of them.
 */
-void OperatingSystem::setRunning(ProcessControlBlock process) throw (std::logic_error){
+void OperatingSystem::setRunning(ProcessControlBlock &process) throw (std::logic_error){
 	// Can move to RUNNING from READY, only
 	//if (process.getState() == ProcessControlBlock::READY) {
 		process.changeState(ProcessControlBlock::RUNNING);
@@ -282,7 +350,7 @@ void OperatingSystem::setRunning(ProcessControlBlock process) throw (std::logic_
 *	@param process to be changed
 *	@throw there are rules for how a process can move from one state to another; this function tried to break one of them.
 */
-void OperatingSystem::setWaiting(ProcessControlBlock process) throw (std::logic_error){
+void OperatingSystem::setWaiting(ProcessControlBlock &process) throw (std::logic_error){
 	// Can move to WAITING from RUNNING, only
 	//if (process.getState() == ProcessControlBlock::RUNNING) {
 		process.changeState(ProcessControlBlock::WAITING);
@@ -297,7 +365,7 @@ void OperatingSystem::setWaiting(ProcessControlBlock process) throw (std::logic_
 *	@param process to be changed
 *	@throw there are rules for how a process can move from one state to another; this function tried to break one of them.
 */
-void OperatingSystem::setExit(ProcessControlBlock process) throw (std::logic_error){
+void OperatingSystem::setExit(ProcessControlBlock &process) throw (std::logic_error){
 	// Can move to EXIT from RUNNING, only
 	//if (process.getState() == ProcessControlBlock::RUNNING) {
 		process.changeState(ProcessControlBlock::EXIT);
@@ -335,92 +403,358 @@ bool OperatingSystem::MetaData::getInitializedStatus() const{
 
 /** Meta Data Init.
 *	\n Initializes all Meta-Data via meta-data file path specified in configuration data.
-*	Opens the file containing meta-data information, then reads in the data from the specifically formatted file.
+*	Maps the file containing meta-data information into memory, then reads in the data from the specifically formatted file.
+*	Large files are split into chunks at application boundaries (A{begin}), and each chunk is parsed on its own thread;
+*	the items of each chunk are then moved, in order, into the Meta-Data container.
 *	@pre Configuration data must be read and processed.
-*	@param fin is an input filestream object which holds meta-data information
 *	@param metaDataFilename the name of the file which holds meta-data information
-*	@throw Error in opening meta-data file
+*	@throw Error in opening meta-data file, or in reading a meta-data item; item errors give the item's position
 */
 void OperatingSystem::MetaData::MetaDataInit(std::string metaDataFilename) throw(std::logic_error) {
-	std::ifstream fin;
+	PROFILE_ZONE("meta-data parse");
+	const char* text;
+	size_t size;
 
-	fin.open(metaDataFilename);		// open meta data file
+	// Map the file into memory
+#ifdef _WIN32
+	std::ifstream fin(metaDataFilename.c_str(), std::ios::binary);
 	if (!fin.good()) {
 		throw std::logic_error("Meta-Data file path unresolved; check config file.");		// If file opening fails, throw error
 	}
+	std::string contents((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+	text = contents.data();
+	size = contents.size();
+#else
+	int fd = open(metaDataFilename.c_str(), O_RDONLY);
+	struct stat status;
+	if (fd < 0 || fstat(fd, &status) != 0) {
+		if (fd >= 0) {
+			close(fd);
+		}
+		throw std::logic_error("Meta-Data file path unresolved; check config file.");		// If file opening fails, throw error
+	}
+	size = status.st_size;
+	void* mapping = size > 0 ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+	close(fd);
+	if (size > 0 && mapping == MAP_FAILED) {
+		throw std::logic_error("Meta-Data file path unresolved; check config file.");
+	}
+	text = (const char*)mapping;
+#endif
 
-	// Read from file
-	ReadDescriptor(fin, '\n');								// Read in "Start Program Meta-Data Code:"
-	while (fin.peek() != '.') {								// While there is Meta-data to read (delimited by '.')
+	try {
+		ParseText(text, text + size);
+	}
+	catch (std::logic_error&) {
+#ifndef _WIN32
+		if (size > 0) {
+			munmap(mapping, size);
+		}
+#endif
+		throw;
+	}
 
-		if ((fin >> std::ws).peek() == '{')					// Check for meta-data code
-			throw std::logic_error("Meta-Data code missing from meta-data block; check meta-data file.");
+	// Initialization complete, unmap file
+#ifndef _WIN32
+	if (size > 0) {
+		munmap(mapping, size);
+	}
+#endif
 
-		metaDataItem.code = ReadCode(fin);					// Read in meta data code
-		fin.get();											// eat '{'
+	metaDataInitialized =  true;
+}
 
-		if ((fin >> std::ws).peek() == '}')					// Check for meta-data descriptor
-			throw std::logic_error("Meta-Data descriptor missing from meta-data block; check meta-data file.");
+/** Parse Text
+*	\n Reads the "Start Program Meta-Data Code:" line and the closing "End Program Meta-Data Code." from the text, then
+*	parses the items between them, in parallel chunks if the text is large.
+*	@param begin is the first character of the meta-data file
+*	@param end is one past the last character of the meta-data file
+*	@throw Error in the start or end code, or in reading a meta-data item
+*/
+void OperatingSystem::MetaData::ParseText(const char* begin, const char* end) throw(std::logic_error) {
+	// Read in "Start Program Meta-Data Code:"
+	const char* bodyBegin = std::find(begin, end, '\n');
+	if (!IsDescriptor(std::string(begin, bodyBegin))) {
+		throw std::logic_error("Meta-Data descriptor read error; check Meta-Data file.");
+	}
+	if (bodyBegin != end) {
+		bodyBegin++;
+	}
 
-		metaDataItem.descriptor = ReadDescriptor(fin, '}');	// Read in descriptor
+	// Read in "End Program Meta-Data Code" from the end of the file; items end at the '.' before it
+	const std::string endCode = "End Program Meta-Data Code";
+	const char* trailer = end;
+	while (trailer != bodyBegin && isspace((unsigned char)trailer[-1])) {
+		trailer--;
+	}
+	if (trailer == bodyBegin || trailer[-1] != '.' || trailer - bodyBegin < (long)endCode.size() + 1
+		|| std::string(trailer - 1 - endCode.size(), trailer - 1) != endCode) {
+		throw std::logic_error("Meta-Data descriptor read error; check Meta-Data file.");
+	}
+	const char* bodyEnd = trailer - 1 - endCode.size();
+	while (bodyEnd != bodyBegin && isspace((unsigned char)bodyEnd[-1])) {
+		bodyEnd--;
+	}
+	if (bodyEnd == bodyBegin || bodyEnd[-1] != '.') {
+		throw std::logic_error("Meta-Data descriptor read error; check Meta-Data file.");
+	}
+	bodyEnd--;
+
+	// Split the items into chunks of at least minChunkSize, each starting at an application
+#ifdef _WIN32
+	long threadCount = 1;
+#else
+	long threadCount = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	size_t bodySize = bodyEnd - bodyBegin;
+	size_t chunkCount = std::max(1L, std::min(threadCount, (long)(bodySize / minChunkSize)));
+	std::vector<Chunk> chunks;
+	const char* chunkBegin = bodyBegin;
+	for (size_t i = 1; i < chunkCount; i++) {
+		const char* split = FindApplication(std::max(chunkBegin + 1, bodyBegin + bodySize * i / chunkCount), bodyEnd);
+		if (split == bodyEnd) {
+			break;
+		}
+		chunks.push_back(Chunk(this, chunkBegin, split));
+		chunkBegin = split;
+	}
+	chunks.push_back(Chunk(this, chunkBegin, bodyEnd));
 
-		if ((fin >> std::ws).peek() == ';')					// Check for meta-data cycle time
-			throw std::logic_error("Meta-Data cycle time missing from meta-data block; check meta-data file.");
+	// Parse every chunk; the first is parsed on this thread
+	std::vector<pthread_t> threads(chunks.size());
+	for (size_t i = 1; i < chunks.size(); i++) {
+		pthread_create(&threads[i], NULL, ParseChunk, (void*)&chunks[i]);
+	}
+	ParseChunk((void*)&chunks[0]);
+	for (size_t i = 1; i < chunks.size(); i++) {
+		pthread_join(threads[i], NULL);
+	}
 
-		fin >> metaDataItem.timeVal;						// Read in time
-		if (fin.peek() != '.') {
-			fin.get();										// eat ';'
+	// Report the first error by its position in the whole file
+	size_t total = 0;
+	for (size_t i = 0; i < chunks.size(); i++) {
+		if (chunks[i].failed) {
+			throw std::logic_error(chunks[i].error + " at item " + std::to_string(total + chunks[i].items.size() + 1)
+				+ "; check Meta-Data file.");
 		}
-		metaDataItems.push_back(metaDataItem);				// Load meta data block into Meta-Data container
+		total += chunks[i].items.size();
 	}
-	fin.get();												// eat '.'
-	fin.get();												// eat '\n'
-	ReadDescriptor(fin, '.');								// Read in "End Program Meta-Data Code"
 
-	// Initialization complete, close file
-	fin.close();
+	// Load meta data blocks into Meta-Data container
+	metaDataItems.clear();
+	metaDataItems.reserve(total);
+	for (size_t i = 0; i < chunks.size(); i++) {
+		metaDataItems.insert(metaDataItems.end(), std::make_move_iterator(chunks[i].items.begin()),
+			std::make_move_iterator(chunks[i].items.end()));
+		std::vector<MetaDataItem>().swap(chunks[i].items);
+	}
+}
 
-	metaDataInitialized =  true;
+/** Find Application
+*	\n Finds the first "A{begin}" item at or after a position, where a chunk of items may safely start.
+*	@param from is the position to search from
+*	@param end is one past the last character to search
+*	@return the start of the item, or end if there is none
+*/
+const char* OperatingSystem::MetaData::FindApplication(const char* from, const char* end) const {
+	static const char application[] = "A{begin}";
+	const char* found = from;
+
+	for (;;) {
+		found = std::search(found, end, application, application + sizeof(application) - 1);
+		if (found == end || isspace((unsigned char)found[-1]) || found[-1] == ';') {
+			return found;
+		}
+		found++;
+	}
+}
+
+/** Parse Chunk
+*	\n A process that can be called in the creation of a thread which parses one chunk of meta-data items. A chunk stops
+*	at its first error, keeping the items read before it so the error's position can be found.
+*	@param threadarg is the Chunk being parsed
+*/
+void* OperatingSystem::MetaData::ParseChunk(void* threadarg) {
+	Chunk* chunk = (Chunk*)threadarg;
+	PROFILE_ZONE("meta-data chunk");
+
+	try {
+		chunk->metaData->ParseItems(*chunk);
+	}
+	catch (std::logic_error &e) {
+		chunk->failed = true;
+		chunk->error = e.what();
+	}
+
+	return NULL;
+}
+
+/** Parse Items
+*	\n Reads every meta-data item in a chunk, each in the form code{descriptor}cycles and separated by ';'.
+*	@param chunk is the chunk being parsed; its items are appended to chunk.items
+*	@throw Error in reading a meta-data item, without its position
+*/
+void OperatingSystem::MetaData::ParseItems(Chunk &chunk) const throw(std::logic_error) {
+	const char* pos = chunk.begin;
+	const char* end = chunk.end;
+
+	while (SkipSpace(pos, end) != end) {
+		MetaDataItem metaDataItem;
+
+		if (*pos == '{')									// Check for meta-data code
+			throw std::logic_error("Meta-Data code missing from meta-data block");
+
+		metaDataItem.code = ReadCode(pos, end);				// Read in meta data code
+		if (pos != end) {
+			pos++;											// eat '{'
+		}
+
+		if (SkipSpace(pos, end) != end && *pos == '}')		// Check for meta-data descriptor
+			throw std::logic_error("Meta-Data descriptor missing from meta-data block");
+
+		metaDataItem.cylinder = 0;
+		metaDataItem.descriptor = ReadDescriptor(metaDataItem, pos, end);	// Read in descriptor (and cylinder, if any)
+
+		if (SkipSpace(pos, end) == end || *pos == ';')		// Check for meta-data cycle time
+			throw std::logic_error("Meta-Data cycle time missing from meta-data block");
+
+		metaDataItem.timeVal = ReadCycles(pos, end);		// Read in time
+		if (pos != end) {
+			if (*pos != ';')
+				throw std::logic_error("Meta-Data block must end with ';'");
+			pos++;											// eat ';'
+		}
+		chunk.items.push_back(std::move(metaDataItem));
+	}
+}
+
+/** Skip Space
+*	\n Advances past whitespace.
+*	@param pos is the read position, advanced past any whitespace
+*	@param end is one past the last character which may be read
+*	@return the new read position
+*/
+const char* OperatingSystem::MetaData::SkipSpace(const char* &pos, const char* end) {
+	while (pos != end && isspace((unsigned char)*pos)) {
+		pos++;
+	}
+	return pos;
 }
 
 /** Read Code
 *	\n Reads in a meta-data code, then tests it for validity.
-*	@param fin is the input filestream object from which the code is read
+*	@param pos is the read position, advanced past the code
+*	@param end is one past the last character which may be read
 *	@return A verified meta-data code
 *	@throw Error caused by invalid code
 */
-char OperatingSystem::MetaData::ReadCode(std::ifstream & fin) throw(std::logic_error) {
-	char read;
-
-	(fin >> std::ws).get(read);
+char OperatingSystem::MetaData::ReadCode(const char* &pos, const char* end) const throw(std::logic_error) {
+	if (SkipSpace(pos, end) != end) {
+		char read = *pos++;
 
-	for (unsigned int i = 0; i < sizeof(codes); i++) {
-		if (read == codes[i]) {
-			return read;
+		for (unsigned int i = 0; i < sizeof(codes); i++) {
+			if (read == codes[i]) {
+				return read;
+			}
 		}
 	}
 
-	throw std::logic_error("Meta-Data code read error; check Meta-Data file.");
+	throw std::logic_error("Meta-Data code read error");
 }
 
 /** Read Descriptor
-*	\n Reads in a meta-data descriptor, then tests it for validity.
-*	@param fin is the input filestream object from which the descriptor is read
+*	\n Reads in a meta-data descriptor up to its closing '}', then tests it for validity.
+*	@param metaDataItem receives the cylinder or page trace named by the descriptor, if any
+*	@param pos is the read position, advanced past the closing '}'
+*	@param end is one past the last character which may be read
 *	@return A verified meta-data descriptor
 *	@throw Error caused by invalid descriptor
 */
-std::string OperatingSystem::MetaData::ReadDescriptor(std::ifstream & fin, char delimiter) throw(std::logic_error) {
-	std::string read;
+std::string OperatingSystem::MetaData::ReadDescriptor(MetaDataItem &metaDataItem, const char* &pos, const char* end) const throw(std::logic_error) {
+	const char* close = std::find(pos, end, '}');
+	std::string read(pos, close);
+	pos = close != end ? close + 1 : end;
+
+	// Disk scheduled devices may name a cylinder: {hard drive:cylinder}
+	// Memory blocking may name the pages it touches, in order: {block:page,page,...}
+	std::string::size_type split = read.find(':');
+	if (split != std::string::npos) {
+		std::string argument = read.substr(split + 1);
+		read = read.substr(0, split);
+		if (read == "block") {
+			std::istringstream pages(argument);
+			std::string page;
+			while (std::getline(pages, page, ',')) {
+				if (page.empty() || page.find_first_not_of("0123456789") != std::string::npos) {
+					throw std::logic_error("Meta-Data page trace read error");
+				}
+				metaDataItem.pages.push_back(strtoul(page.c_str(), NULL, 10));
+			}
+			if (metaDataItem.pages.empty()) {
+				throw std::logic_error("Meta-Data page trace read error");
+			}
+		}
+		else {
+			// The cylinder must be on the drive, if the drive's geometry is configured
+			const Config::DeviceSpec* device = conf.resources.FindDevice(read);
+			if (device == NULL || device->queue != Config::DeviceSpec::DISK
+				|| argument.empty() || argument.find_first_not_of("0123456789") != std::string::npos) {
+				throw std::logic_error("Meta-Data cylinder read error");
+			}
+			metaDataItem.cylinder = atoi(argument.c_str());
+			if (metaDataItem.cylinder < 0 || (device->cylinders > 0 && metaDataItem.cylinder >= device->cylinders)) {
+				throw std::logic_error("Meta-Data cylinder read error");
+			}
+		}
+	}
+
+	if (IsDescriptor(read)) {
+		return read;
+	}
+
+	throw std::logic_error("Meta-Data descriptor read error");
+}
+
+/** Read Cycles
+*	\n Reads in the cycle count of a meta-data item.
+*	@param pos is the read position, advanced past the number
+*	@param end is one past the last character which may be read
+*	@return the number of cycles
+*	@throw Error caused by a missing or malformed number
+*/
+int OperatingSystem::MetaData::ReadCycles(const char* &pos, const char* end) const throw(std::logic_error) {
+	bool negative = false;
+	long cycles = 0;
+
+	if (pos != end && (*pos == '-' || *pos == '+')) {
+		negative = (*pos++ == '-');
+	}
+	if (pos == end || !isdigit((unsigned char)*pos)) {
+		throw std::logic_error("Meta-Data cycle time read error");
+	}
+	while (pos != end && isdigit((unsigned char)*pos)) {
+		cycles = cycles * 10 + (*pos++ - '0');
+		if (cycles > INT_MAX) {
+			throw std::logic_error("Meta-Data cycle time read error");
+		}
+	}
 
-	std::getline(fin, read, delimiter);
+	return negative ? -cycles : cycles;
+}
 
+/** Is Descriptor
+*	\n Tests a meta-data descriptor for validity. Besides the fixed descriptors, every device in the configuration's
+*	registry is a descriptor.
+*	@param read is the descriptor
+*	@return true if the descriptor is known
+*/
+bool OperatingSystem::MetaData::IsDescriptor(const std::string &read) const {
 	for (unsigned int i = 0; i < (sizeof(descriptors) / sizeof(descriptors[0])); i++) {		// Loop for each element in array
 		if (read == descriptors[i]) {
-			return read;
+			return true;
 		}
 	}
-
-	throw std::logic_error("Meta-Data descriptor read error; check Meta-Data file.");
+	return conf.resources.FindDevice(read) != NULL;
 }
 
 /** Calculate Run Time
@@ -435,5 +769,5 @@ std::string OperatingSystem::MetaData::ReadDescriptor(std::ifstream & fin, char
 *	@note AS OF LATEST VERSION, NEED TO SIMPLIFY THIS FUNCTION IN LIGHT OF ADDITION OF EXTERN CONFIG DECLARATION**************
 */
 int OperatingSystem::MetaData::CalculateRunTime(char metaCode, std::string metaDescriptor, int metaTime) const {
-	return metaTime * conf.GetOperationTime(metaCode, metaDescriptor);
+	return conf.GetServiceTime(metaCode, metaDescriptor, metaTime);
 }
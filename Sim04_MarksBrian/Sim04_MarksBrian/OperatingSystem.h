@@ -1,10 +1,12 @@
 /**
 *	@file OperatingSystem.h
 *	@author Brian Marks
-*	@version 1.4
+*	@version 1.6
 *	@details Class declaration for a simulation of a running operating system
 *	@date Wednesday, April 18, 2018
 *	@note 1.4 update includes process scheduling
+*	@note 1.5 update lets a loaded workload be run again under another configuration, for batch runs
+*	@note 1.6 update records or replays the interleaving of real-time runs
 */
 
 //
@@ -19,16 +21,35 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <vector>
+#include <deque>
+#include <algorithm>
+#include <iterator>
 #include <stdexcept>
+#include <cstdlib>
+#include <cctype>
+#include <climits>
+#include <pthread.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 #include "Config.h"
+#include "ConfigWatcher.h"
 #include "Log.h"
 #include "ProcessControlBlock.h"
 #include "ResourceManager.h"
+#include "Executor.h"
+#include "WorkStealingScheduler.h"
+#include "Trace.h"
 
 extern Config conf;
 extern Log logger;
+extern Trace trace;
 
 typedef ProcessControlBlock::Operation Operation;
 typedef ProcessControlBlock::State State;
@@ -42,6 +63,8 @@ struct MetaDataItem {
 	char code;
 	std::string descriptor;
 	int timeVal;
+	int cylinder;		// Hard drive cylinder, given as {hard drive:cylinder}
+	std::vector<unsigned long> pages;	// Pages a memory block touches, given as {block:page,page,...}
 };
 
 class OperatingSystem {
@@ -61,11 +84,13 @@ public:
 	
 	// Simulator functions
 	void runSimulation() throw (std::logic_error);
+	void reconfigure() throw (std::logic_error);
+	Executor::Metrics getRunMetrics() const;
 
-	void setReady(ProcessControlBlock process) throw (std::logic_error);	// Process State setters
-	void setRunning(ProcessControlBlock process) throw (std::logic_error);
-	void setWaiting(ProcessControlBlock process) throw (std::logic_error);
-	void setExit(ProcessControlBlock process) throw (std::logic_error);
+	void setReady(ProcessControlBlock &process) throw (std::logic_error);	// Process State setters
+	void setRunning(ProcessControlBlock &process) throw (std::logic_error);
+	void setWaiting(ProcessControlBlock &process) throw (std::logic_error);
+	void setExit(ProcessControlBlock &process) throw (std::logic_error);
 
 private:
 	// Container of all processes (set of meta-data codes from A{begin}0; to A{finish}0;)
@@ -76,6 +101,9 @@ private:
 
 	// Resource manager
 	ResourceManager resourceManager;
+
+	// Summary of the last virtual time run
+	Executor::Metrics runMetrics;
 	
 	// Control statuses
 	bool systemStarted;
@@ -97,30 +125,49 @@ private:
 		void MetaDataInit(std::string metaDataFilename) throw(std::logic_error);
 
 		// Additional Functions
-		char ReadCode(std::ifstream& fin) throw(std::logic_error);
-		std::string ReadDescriptor(std::ifstream& fin, char delimiter) throw(std::logic_error);
+		char ReadCode(const char* &pos, const char* end) const throw(std::logic_error);
+		std::string ReadDescriptor(MetaDataItem &metaDataItem, const char* &pos, const char* end) const throw(std::logic_error);
+		int ReadCycles(const char* &pos, const char* end) const throw(std::logic_error);
 		int CalculateRunTime(char metaCode, std::string metaDescriptor, int metaTime) const;
 
 		// Debugging functions
 		//void ShowMetaData(std::ofstream & fout, std::string loggingSetting) const;
 
-		// Individual Meta-Data Item
-		MetaDataItem metaDataItem;
-
 		// Container of all Meta-Data items
 		std::vector<MetaDataItem> metaDataItems;
 
 	private:
+		// A run of whole applications parsed on its own thread
+		struct Chunk {
+			Chunk(const MetaData* parser, const char* first, const char* last) : metaData(parser), begin(first), end(last), failed(false) {};
+
+			const MetaData* metaData;
+			const char* begin;				// First character of the chunk
+			const char* end;				// One past the last character of the chunk
+			std::vector<MetaDataItem> items;
+			bool failed;					// true if the chunk stopped at an error, after items
+			std::string error;
+		};
+
+		// Parsing functions
+		void ParseText(const char* begin, const char* end) throw(std::logic_error);
+		const char* FindApplication(const char* from, const char* end) const;
+		static void* ParseChunk(void* threadarg);
+		void ParseItems(Chunk &chunk) const throw(std::logic_error);
+		static const char* SkipSpace(const char* &pos, const char* end);
+		bool IsDescriptor(const std::string &read) const;
+
+		// Smallest chunk worth a thread of its own (bytes)
+		static const size_t minChunkSize = 1 << 20;
 
 		bool metaDataInitialized;
 
 		// Error handling data items
 		char codes[6] = { 'S', 'A', 'P', 'I', 'O', 'M' };
-		std::string descriptors[12] = { "begin", "finish", "hard drive",
-			"keyboard", "scanner", "monitor",
-			"run", "allocate", "projector",
+		std::string descriptors[8] = { "begin", "finish",
+			"run", "allocate", "free",
 			"block", "Start Program Meta-Data Code:",
-			"End Program Meta-Data Code" };
+			"End Program Meta-Data Code" };			// Devices are looked up in the configuration's registry
 
 	};	// End of Meta-Data class
 
@@ -0,0 +1,336 @@
+/**
+*	@file PageReplacer.cpp
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class implementation for the page replacement engine with FIFO, LRU, CLOCK and ARC policies.
+*	@date Sunday, April 29, 2018
+*/
+
+//
+// Header Files ///////////////////////////
+//
+#include "PageReplacer.h"
+
+//
+// Class Function Definitions /////////////////
+//
+
+/**	Make Key
+*	\n Combines a process ID and page number into a key naming the page across every process.
+*	@param processID is the process owning the page
+*	@param page is the page number within the process
+*	@return the key of the page
+*/
+PageReplacer::PageKey PageReplacer::MakeKey(int processID, unsigned long page) {
+	return ((PageKey)(unsigned int)processID << 32) | (page & 0xFFFFFFFFUL);
+}
+
+/**	Constructor
+*	\n Creates a FIFO replacer with no frames.
+*/
+PageReplacer::PageReplacer() {
+	policy = FIFO;
+	Initialize(0);
+}
+
+/**	Set Policy
+*	\n Translates the "Page Replacement Code" from the config file into a replacement policy.
+*	@pre Every frame must be free.
+*	@param code is FIFO, LRU, CLOCK, or ARC
+*	@throw the code is not a known replacement policy
+*/
+void PageReplacer::SetPolicy(std::string code) throw(std::logic_error) {
+	if (code == "FIFO") {
+		policy = FIFO;
+	}
+	else if (code == "LRU") {
+		policy = LRU;
+	}
+	else if (code == "CLOCK") {
+		policy = CLOCK;
+	}
+	else if (code == "ARC") {
+		policy = ARC;
+	}
+	else {
+		throw std::logic_error("Page replacement code is either incompatible or undefined; check configuration file.");
+	}
+}
+
+/**	Initialize
+*	\n Sizes the replacer for a frame pool, every frame free, and forgets every evicted page.
+*	@param frameCount is the number of physical frames
+*/
+void PageReplacer::Initialize(unsigned long frameCount) {
+	capacity = frameCount;
+	keys.assign(frameCount, 0);
+	prev.assign(frameCount, -1);
+	next.assign(frameCount, -1);
+	member.assign(frameCount, NONE);
+	referenced.assign(frameCount, 0);
+
+	lists[0] = FrameList();
+	lists[1] = FrameList();
+	hand = 0;
+
+	ghosts[0].clear();
+	ghosts[1].clear();
+	ghostIndex.clear();
+	target = 0;
+	faultGhost = NONE;
+	dropVictim = false;
+}
+
+/**	Fault
+*	\n Notes a page fault before the page is placed. Only ARC acts on it: a page found in a ghost list was evicted too
+*	early, so the target size of T1 moves toward the list which would have kept it; a page never seen makes room in the
+*	ghost lists, which together never remember more pages than twice the number of frames.
+*	@param key is the page being loaded
+*/
+void PageReplacer::Fault(PageKey key) {
+	if (policy != ARC) {
+		return;
+	}
+
+	std::unordered_map<PageKey, Ghost>::iterator ghost = ghostIndex.find(key);
+	if (ghost != ghostIndex.end()) {
+		unsigned long recent = ghosts[RECENT].size();
+		unsigned long frequent = ghosts[FREQUENT].size();
+
+		if (ghost->second.frequent) {
+			unsigned long delta = recent > frequent ? recent / frequent : 1;
+			target = target > delta ? target - delta : 0;
+			faultGhost = FREQUENT;
+		}
+		else {
+			unsigned long delta = frequent > recent ? frequent / recent : 1;
+			target = target + delta < capacity ? target + delta : capacity;
+			faultGhost = RECENT;
+		}
+		ghosts[faultGhost].erase(ghost->second.position);
+		ghostIndex.erase(ghost);
+		return;
+	}
+
+	faultGhost = NONE;
+	unsigned long recentPages = lists[RECENT].size + ghosts[RECENT].size();
+	unsigned long totalPages = recentPages + lists[FREQUENT].size + ghosts[FREQUENT].size();
+	if (recentPages >= capacity) {
+		if (!ghosts[RECENT].empty()) {
+			DropGhost(false);
+		}
+		else {
+			dropVictim = true;
+		}
+	}
+	else if (totalPages >= 2 * capacity && !ghosts[FREQUENT].empty()) {
+		DropGhost(true);
+	}
+}
+
+/**	Victim
+*	\n Chooses a resident page to evict and removes its frame from the replacer.
+*	@pre At least one frame must be resident.
+*	@return the frame to reuse
+*/
+unsigned long PageReplacer::Victim() {
+	unsigned long frame;
+
+	switch (policy) {
+		case CLOCK:
+			// Give every referenced page a second chance
+			for (;;) {
+				frame = hand;
+				hand = (hand + 1) % capacity;
+				if (member[frame] == NONE) {
+					continue;
+				}
+				if (referenced[frame]) {
+					referenced[frame] = 0;
+					continue;
+				}
+				member[frame] = NONE;
+				return frame;
+			}
+
+		case ARC: {
+			// Evict from T1 while it is over its target, otherwise from T2; the evicted page is remembered
+			unsigned long recent = lists[RECENT].size;
+			bool fromRecent = recent > 0 && (dropVictim || lists[FREQUENT].size == 0 || recent > target
+				|| (faultGhost == FREQUENT && recent == target));
+			frame = lists[fromRecent ? RECENT : FREQUENT].head;
+			Unlink(frame);
+			if (!(fromRecent && dropVictim)) {
+				AddGhost(!fromRecent, keys[frame]);
+			}
+			dropVictim = false;
+			return frame;
+		}
+
+		default:
+			// FIFO and LRU both evict from the head of the list
+			frame = lists[RESIDENT].head;
+			Unlink(frame);
+			return frame;
+	}
+}
+
+/**	Insert
+*	\n Places a newly loaded page in a frame.
+*	@param frame is the frame now holding the page
+*	@param key is the page loaded
+*/
+void PageReplacer::Insert(unsigned long frame, PageKey key) {
+	keys[frame] = key;
+
+	switch (policy) {
+		case CLOCK:
+			member[frame] = RESIDENT;
+			referenced[frame] = 1;
+			break;
+
+		case ARC:
+			// A page evicted recently has been used twice, so it joins T2
+			PushBack(faultGhost == NONE ? RECENT : FREQUENT, frame);
+			faultGhost = NONE;
+			dropVictim = false;
+			break;
+
+		default:
+			PushBack(RESIDENT, frame);
+	}
+}
+
+/**	Touch
+*	\n Records a use of a resident page.
+*	@param frame is the frame holding the page
+*/
+void PageReplacer::Touch(unsigned long frame) {
+	switch (policy) {
+		case LRU:
+			Unlink(frame);
+			PushBack(RESIDENT, frame);
+			break;
+
+		case CLOCK:
+			referenced[frame] = 1;
+			break;
+
+		case ARC:
+			Unlink(frame);
+			PushBack(FREQUENT, frame);
+			break;
+
+		default:
+			break;
+	}
+}
+
+/**	Remove
+*	\n Frees a frame whose page was released by its process. Released pages are not remembered.
+*	@param frame is the frame being freed
+*/
+void PageReplacer::Remove(unsigned long frame) {
+	if (policy == CLOCK) {
+		member[frame] = NONE;
+		referenced[frame] = 0;
+	}
+	else if (member[frame] != NONE) {
+		Unlink(frame);
+	}
+}
+
+/**	Get Policy
+*	\n Getter function for the replacement policy.
+*	@return the replacement policy
+*/
+PageReplacer::Policy PageReplacer::GetPolicy() const {
+	return policy;
+}
+
+/**	Get Policy Name
+*	\n Names the replacement policy, for the log.
+*	@return the config code of the replacement policy
+*/
+std::string PageReplacer::GetPolicyName() const {
+	switch (policy) {
+		case LRU:
+			return "LRU";
+		case CLOCK:
+			return "CLOCK";
+		case ARC:
+			return "ARC";
+		default:
+			return "FIFO";
+	}
+}
+
+/**	Push Back
+*	\n Appends a frame to the tail (most recent end) of a list.
+*	@param list is the list joined
+*	@param frame is the frame appended
+*/
+void PageReplacer::PushBack(int list, unsigned long frame) {
+	FrameList &frameList = lists[list];
+
+	prev[frame] = frameList.tail;
+	next[frame] = -1;
+	if (frameList.tail >= 0) {
+		next[frameList.tail] = frame;
+	}
+	else {
+		frameList.head = frame;
+	}
+	frameList.tail = frame;
+	frameList.size++;
+	member[frame] = list;
+}
+
+/**	Unlink
+*	\n Removes a frame from whichever list holds it.
+*	@param frame is the frame removed
+*/
+void PageReplacer::Unlink(unsigned long frame) {
+	FrameList &frameList = lists[member[frame]];
+
+	if (prev[frame] >= 0) {
+		next[prev[frame]] = next[frame];
+	}
+	else {
+		frameList.head = next[frame];
+	}
+	if (next[frame] >= 0) {
+		prev[next[frame]] = prev[frame];
+	}
+	else {
+		frameList.tail = prev[frame];
+	}
+	frameList.size--;
+	member[frame] = NONE;
+}
+
+/**	Add Ghost
+*	\n Remembers an evicted page at the most recent end of a ghost list.
+*	@param frequent is true for B2, false for B1
+*	@param key is the page evicted
+*/
+void PageReplacer::AddGhost(bool frequent, PageKey key) {
+	std::list<PageKey> &ghostList = ghosts[frequent ? FREQUENT : RECENT];
+
+	ghostList.push_back(key);
+	Ghost ghost;
+	ghost.frequent = frequent;
+	ghost.position = --ghostList.end();
+	ghostIndex[key] = ghost;
+}
+
+/**	Drop Ghost
+*	\n Forgets the least recently evicted page of a ghost list.
+*	@param frequent is true for B2, false for B1
+*/
+void PageReplacer::DropGhost(bool frequent) {
+	std::list<PageKey> &ghostList = ghosts[frequent ? FREQUENT : RECENT];
+
+	ghostIndex.erase(ghostList.front());
+	ghostList.pop_front();
+}
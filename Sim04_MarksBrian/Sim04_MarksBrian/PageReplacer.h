@@ -0,0 +1,115 @@
+/**
+*	@file PageReplacer.h
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class declaration for the page replacement engine of the paging unit. The engine tracks which frames are
+*	resident and chooses a victim frame when a page fault finds no free frame, by one of several replacement policies.
+*	Every operation is O(1): FIFO and LRU keep an intrusive list threaded through the frames, CLOCK sweeps reference
+*	bits, and ARC keeps two intrusive frame lists plus two ghost lists of recently evicted pages.
+*	@date Sunday, April 29, 2018
+*/
+
+//
+// Compiler Guards ////////////////////////
+//
+#ifndef PAGEREPLACER_H
+#define PAGEREPLACER_H
+
+//
+// Header Files ///////////////////////////
+//
+#include <list>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <unordered_map>
+
+//
+// Class Declaration ///////////////////////////
+//
+class PageReplacer {
+public:
+	// Page replacement policies
+	enum Policy {
+		FIFO,		// Evict the page loaded the longest ago
+		LRU,		// Evict the page used the longest ago
+		CLOCK,		// Second chance: sweep the frames, evicting the first page not referenced since the last sweep
+		ARC			// Adaptive replacement cache: balance recency against frequency using recently evicted pages
+	};
+
+	// Identifies a page across every process: the process ID in the high word, the page number in the low word
+	typedef unsigned long long PageKey;
+	static PageKey MakeKey(int processID, unsigned long page);
+
+	// Constructor
+	PageReplacer();
+
+	// Initialization functions
+	void SetPolicy(std::string code) throw(std::logic_error);
+	void Initialize(unsigned long frameCount);
+
+	// Replacement functions
+	void Fault(PageKey key);
+	unsigned long Victim();
+	void Insert(unsigned long frame, PageKey key);
+	void Touch(unsigned long frame);
+	void Remove(unsigned long frame);
+
+	// Accessors
+	Policy GetPolicy() const;
+	std::string GetPolicyName() const;
+
+private:
+	// Intrusive lists threaded through the frames, least recently inserted or used at the head
+	enum ListID {
+		NONE = -1,
+		RESIDENT = 0,		// FIFO and LRU: every resident frame
+		RECENT = 0,			// ARC T1: frames used once since loaded
+		FREQUENT = 1		// ARC T2: frames used more than once, or reloaded soon after eviction
+	};
+
+	struct FrameList {
+		FrameList() : head(-1), tail(-1), size(0) {};
+
+		long head;
+		long tail;
+		unsigned long size;
+	};
+
+	// ARC ghost lists: keys of evicted pages, least recently evicted at the front
+	struct Ghost {
+		bool frequent;						// true if in B2, otherwise in B1
+		std::list<PageKey>::iterator position;
+	};
+
+	// Private functions
+	void PushBack(int list, unsigned long frame);
+	void Unlink(unsigned long frame);
+	void AddGhost(bool frequent, PageKey key);
+	void DropGhost(bool frequent);
+
+	Policy policy;
+	unsigned long capacity;
+
+	// Per-frame state, indexed by frame
+	std::vector<PageKey> keys;
+	std::vector<long> prev;
+	std::vector<long> next;
+	std::vector<int> member;				// List holding the frame, or NONE if the frame is free
+	std::vector<char> referenced;			// CLOCK reference bits
+
+	// FIFO, LRU and ARC lists
+	FrameList lists[2];
+
+	// CLOCK hand
+	unsigned long hand;
+
+	// ARC state
+	std::list<PageKey> ghosts[2];
+	std::unordered_map<PageKey, Ghost> ghostIndex;
+	unsigned long target;					// Target size of T1
+	int faultGhost;							// Ghost list which held the faulting page, or NONE
+	bool dropVictim;						// T1 and B1 are full; the next victim leaves no ghost
+};
+
+#endif	// !PAGEREPLACER_H
@@ -0,0 +1,396 @@
+/**
+*	@file PagingUnit.cpp
+*	@author Brian Marks
+*	@version 1.1
+*	@details Class implementation for a simulated paging unit with per-process page tables and a TLB.
+*	@note 1.1 update chooses victim frames by a pluggable replacement policy and keeps fault statistics per process
+*	@date Sunday, April 29, 2018
+*/
+
+//
+// Header Files ///////////////////////////
+//
+#include "PagingUnit.h"
+
+//
+// Class Function Definitions /////////////////
+//
+
+/**	Constructor
+*	\n Creates a paging unit with no frames.
+*/
+PagingUnit::PagingUnit() {
+	pthread_mutex_init(&pagingMutex, NULL);
+	Initialize(0, 1, 0, 1);
+}
+
+/**	Destructor
+*	\n Releases the paging mutex.
+*/
+PagingUnit::~PagingUnit() {
+	pthread_mutex_destroy(&pagingMutex);
+}
+
+/**	Initialize
+*	\n Creates the frame pool and TLB, every frame free and every TLB entry invalid, and clears the statistics.
+*	@param frameCount is the number of physical frames
+*	@param frameSize is the size of a frame, and of a page, in kbytes
+*	@param tlbSize is the number of TLB entries
+*	@param window is the number of most recent accesses whose distinct pages form a process' working set
+*/
+void PagingUnit::Initialize(unsigned long frameCount, unsigned long frameSize, unsigned int tlbSize, unsigned int window) {
+	pageSize = frameSize;
+	frames.assign(frameCount, Frame());
+	freeFrames.clear();
+	for (unsigned long i = frameCount; i > 0; i--) {
+		freeFrames.push_back(i - 1);				// Lowest frame is taken first
+	}
+	replacer.Initialize(frameCount);
+
+	pageTables.clear();
+	nextAccess.clear();
+	allocatedPages.clear();
+	tlb.assign(tlbSize, TLBEntry());
+	tlbClock = 0;
+
+	tlbHits = 0;
+	tlbMisses = 0;
+	pageFaults = 0;
+	evictions = 0;
+	processStats.clear();
+	workingSetWindow = window > 0 ? window : 1;
+}
+
+/**	Set Replacement Policy
+*	\n Chooses how a victim frame is found when a page fault finds every frame in use.
+*	@pre Every frame must be free.
+*	@param code is FIFO, LRU, CLOCK, or ARC
+*	@throw the code is not a known replacement policy
+*/
+void PagingUnit::SetReplacementPolicy(std::string code) throw(std::logic_error) {
+	replacer.SetPolicy(code);
+}
+
+/**	Allocate Page
+*	\n Adds a page to a process' address space. The page is not loaded until it is first touched.
+*	@param processID is the process allocating the page
+*	@return the virtual address of the page
+*/
+unsigned long PagingUnit::AllocatePage(int processID) {
+	trace.Acquire(&pagingMutex, Trace::PAGING);
+	std::vector<PageTableEntry> &pageTable = GetPageTable(processID);
+	pageTable.push_back(PageTableEntry());
+	processStats[processID].references.push_back(0);
+	allocatedPages[processID]++;
+	unsigned long address = (pageTable.size() - 1) * pageSize;
+	pthread_mutex_unlock(&pagingMutex);
+
+	return address;
+}
+
+/**	Free Page
+*	\n Removes a page from a process' address space, freeing its frame if the page is resident.
+*	@param processID is the process freeing the page
+*	@param address is the virtual address of the page
+*	@throw the process has no page allocated at the address
+*/
+void PagingUnit::FreePage(int processID, unsigned long address) throw(std::logic_error) {
+	trace.Acquire(&pagingMutex, Trace::PAGING);
+	std::vector<PageTableEntry> &pageTable = GetPageTable(processID);
+	unsigned long page = address / pageSize;
+
+	if (address % pageSize != 0 || page >= pageTable.size() || !pageTable[page].allocated) {
+		pthread_mutex_unlock(&pagingMutex);
+		throw std::logic_error("Memory freed which the process does not hold; check Meta-Data file.");
+	}
+	if (pageTable[page].present) {
+		UnloadPage(processID, page);
+	}
+	pageTable[page].allocated = false;
+	allocatedPages[processID]--;
+	pthread_mutex_unlock(&pagingMutex);
+}
+
+/**	Access
+*	\n Touches a process' pages, translating each access through the TLB, then the page table. Without a trace the
+*	process touches its pages one after another in turn; with a trace it replays the listed pages in order, starting
+*	over at the end of the list. A page which is not resident is loaded into a frame, evicting a page chosen by the
+*	replacement policy if no frame is free.
+*	@param processID is the process making the accesses
+*	@param accesses is the number of accesses
+*	@param trace is the pages to touch, in order, or empty
+*	@return the number of page faults taken
+*	@throw the trace names a page the process has not allocated
+*/
+unsigned int PagingUnit::Access(int processID, unsigned int accesses, const std::vector<unsigned long> &trace) throw(std::logic_error) {
+	unsigned int faults = 0;
+
+	::trace.Acquire(&pagingMutex, Trace::PAGING);
+	std::vector<PageTableEntry> &pageTable = GetPageTable(processID);
+	ProcessStats &stats = processStats[processID];
+
+	for (unsigned int i = 0; i < trace.size(); i++) {
+		if (trace[i] >= pageTable.size() || !pageTable[trace[i]].allocated) {
+			pthread_mutex_unlock(&pagingMutex);
+			throw std::logic_error("Memory access trace names a page which was not allocated; check Meta-Data file.");
+		}
+	}
+
+	for (unsigned int i = 0; i < accesses && allocatedPages[processID] > 0 && !frames.empty(); i++) {
+		unsigned long page;
+		if (trace.empty()) {
+			// Freed pages are skipped
+			do {
+				page = nextAccess[processID]++ % pageTable.size();
+			} while (!pageTable[page].allocated);
+		}
+		else {
+			page = trace[i % trace.size()];
+		}
+		unsigned long frame;
+
+		RecordAccess(stats, page);
+		if (LookupTLB(processID, page, frame)) {
+			tlbHits++;
+			replacer.Touch(frame);
+			continue;
+		}
+		tlbMisses++;
+
+		if (pageTable[page].present) {
+			frame = pageTable[page].frame;
+			replacer.Touch(frame);
+		}
+		else {
+			frame = LoadPage(processID, page);
+			faults++;
+		}
+		FillTLB(processID, page, frame);
+	}
+	stats.faults += faults;
+	pageFaults += faults;
+	pthread_mutex_unlock(&pagingMutex);
+
+	return faults;
+}
+
+/**	Release Pages
+*	\n Frees every frame and TLB entry held by a process, and its page table.
+*	@param processID is the process releasing its pages
+*/
+void PagingUnit::ReleasePages(int processID) {
+	trace.Acquire(&pagingMutex, Trace::PAGING);
+	std::vector<PageTableEntry> &pageTable = GetPageTable(processID);
+
+	for (unsigned long page = 0; page < pageTable.size(); page++) {
+		if (pageTable[page].present) {
+			UnloadPage(processID, page);
+		}
+	}
+	std::vector<PageTableEntry>().swap(pageTable);
+	allocatedPages[processID] = 0;
+	std::vector<unsigned long>().swap(processStats[processID].recent);
+	std::vector<unsigned int>().swap(processStats[processID].references);
+	pthread_mutex_unlock(&pagingMutex);
+}
+
+/**	Report
+*	\n Formats the TLB and page fault statistics for the log.
+*	@return the statistics as a string
+*/
+std::string PagingUnit::Report() {
+	std::ostringstream out;
+
+	trace.Acquire(&pagingMutex, Trace::PAGING);
+	unsigned long lookups = tlbHits + tlbMisses;
+	out << "TLB " << tlbHits << " hits, " << tlbMisses << " misses (" << std::fixed << std::setprecision(1)
+		<< (lookups > 0 ? 100.0 * tlbHits / lookups : 0.0) << "% hit rate), " << pageFaults << " page faults, "
+		<< evictions << " evictions (" << replacer.GetPolicyName() << " replacement)";
+	pthread_mutex_unlock(&pagingMutex);
+
+	return out.str();
+}
+
+/**	Process Report
+*	\n Formats the paging statistics of one process for the log: its fault rate, the mean and peak size of its working
+*	set, and how many of its pages were evicted.
+*	@param processID is the process
+*	@return the statistics as a string
+*/
+std::string PagingUnit::ProcessReport(int processID) {
+	std::ostringstream out;
+
+	trace.Acquire(&pagingMutex, Trace::PAGING);
+	GetPageTable(processID);
+	const ProcessStats &stats = processStats[processID];
+	out << stats.accesses << " memory accesses, " << stats.faults << " page faults (" << std::fixed << std::setprecision(1)
+		<< (stats.accesses > 0 ? 100.0 * stats.faults / stats.accesses : 0.0) << "% fault rate), working set mean "
+		<< (stats.accesses > 0 ? (double)stats.workingSetTotal / stats.accesses : 0.0) << " pages, peak "
+		<< stats.peakWorkingSet << " pages, " << stats.evictions << " pages evicted";
+	pthread_mutex_unlock(&pagingMutex);
+
+	return out.str();
+}
+
+/**	Get Page Table
+*	\n Finds a process' page table, adding tables as process IDs are first seen.
+*	@pre pagingMutex must be held.
+*	@param processID is the process
+*	@return the process' page table
+*/
+std::vector<PagingUnit::PageTableEntry>& PagingUnit::GetPageTable(int processID) {
+	if ((unsigned int)processID >= pageTables.size()) {
+		pageTables.resize(processID + 1);
+		nextAccess.resize(processID + 1, 0);
+		allocatedPages.resize(processID + 1, 0);
+		processStats.resize(processID + 1);
+	}
+	return pageTables[processID];
+}
+
+/**	Lookup TLB
+*	\n Searches the TLB for a translation.
+*	@pre pagingMutex must be held.
+*	@param processID is the process translating the address
+*	@param page is the page being translated
+*	@param frame receives the frame holding the page on a hit
+*	@return true on a TLB hit
+*/
+bool PagingUnit::LookupTLB(int processID, unsigned long page, unsigned long &frame) {
+	for (unsigned int i = 0; i < tlb.size(); i++) {
+		if (tlb[i].processID == processID && tlb[i].page == page) {
+			tlb[i].lastUse = ++tlbClock;
+			frame = tlb[i].frame;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**	Fill TLB
+*	\n Adds a translation to the TLB, replacing an invalid entry or else the least recently used one.
+*	@pre pagingMutex must be held.
+*	@param processID is the process owning the translation
+*	@param page is the page translated
+*	@param frame is the frame holding the page
+*/
+void PagingUnit::FillTLB(int processID, unsigned long page, unsigned long frame) {
+	if (tlb.empty()) {
+		return;
+	}
+
+	unsigned int victim = 0;
+	for (unsigned int i = 0; i < tlb.size(); i++) {
+		if (tlb[i].processID < 0) {
+			victim = i;
+			break;
+		}
+		if (tlb[i].lastUse < tlb[victim].lastUse) {
+			victim = i;
+		}
+	}
+
+	tlb[victim].processID = processID;
+	tlb[victim].page = page;
+	tlb[victim].frame = frame;
+	tlb[victim].lastUse = ++tlbClock;
+}
+
+/**	Invalidate TLB
+*	\n Removes a translation from the TLB, if present.
+*	@pre pagingMutex must be held.
+*	@param processID is the process owning the translation
+*	@param page is the page no longer resident
+*/
+void PagingUnit::InvalidateTLB(int processID, unsigned long page) {
+	for (unsigned int i = 0; i < tlb.size(); i++) {
+		if (tlb[i].processID == processID && tlb[i].page == page) {
+			tlb[i].processID = -1;
+			tlb[i].lastUse = 0;
+			return;
+		}
+	}
+}
+
+/**	Load Page
+*	\n Services a page fault: places a page in a free frame, or else evicts the page chosen by the replacement policy.
+*	@pre pagingMutex must be held, and there must be at least one frame.
+*	@param processID is the process which faulted
+*	@param page is the page being loaded
+*	@return the frame now holding the page
+*/
+unsigned long PagingUnit::LoadPage(int processID, unsigned long page) {
+	unsigned long frame;
+	PageReplacer::PageKey key = PageReplacer::MakeKey(processID, page);
+
+	replacer.Fault(key);
+	if (!freeFrames.empty()) {
+		frame = freeFrames.back();
+		freeFrames.pop_back();
+	}
+	else {
+		frame = replacer.Victim();
+
+		Frame &victim = frames[frame];
+		pageTables[victim.owner][victim.page].present = false;
+		InvalidateTLB(victim.owner, victim.page);
+		processStats[victim.owner].evictions++;
+		evictions++;
+	}
+	replacer.Insert(frame, key);
+
+	frames[frame].owner = processID;
+	frames[frame].page = page;
+
+	pageTables[processID][page].present = true;
+	pageTables[processID][page].frame = frame;
+	return frame;
+}
+
+/**	Record Access
+*	\n Counts an access and slides the process' working set window over it: the page joins the window, and the access
+*	which falls out of the window leaves it.
+*	@pre pagingMutex must be held, and page must be allocated.
+*	@param stats is the statistics of the process making the access
+*	@param page is the page touched
+*/
+void PagingUnit::RecordAccess(ProcessStats &stats, unsigned long page) {
+	unsigned long slot = stats.accesses % workingSetWindow;
+
+	if (stats.recent.size() < workingSetWindow) {
+		stats.recent.push_back(page);
+	}
+	else {
+		unsigned long oldest = stats.recent[slot];
+		if (--stats.references[oldest] == 0) {
+			stats.workingSet--;
+		}
+		stats.recent[slot] = page;
+	}
+	if (stats.references[page]++ == 0) {
+		stats.workingSet++;
+	}
+
+	stats.accesses++;
+	stats.workingSetTotal += stats.workingSet;
+	if (stats.workingSet > stats.peakWorkingSet) {
+		stats.peakWorkingSet = stats.workingSet;
+	}
+}
+
+/**	Unload Page
+*	\n Frees the frame holding a page which its process no longer needs, and its TLB entry. Unlike an eviction, the page
+*	is not counted against the process.
+*	@pre pagingMutex must be held, and the page must be resident.
+*	@param processID is the process owning the page
+*	@param page is the page
+*/
+void PagingUnit::UnloadPage(int processID, unsigned long page) {
+	PageTableEntry &entry = pageTables[processID][page];
+
+	InvalidateTLB(processID, page);
+	replacer.Remove(entry.frame);
+	frames[entry.frame].owner = -1;
+	freeFrames.push_back(entry.frame);
+	entry.present = false;
+}
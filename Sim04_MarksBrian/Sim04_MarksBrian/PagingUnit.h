@@ -0,0 +1,135 @@
+/**
+*	@file PagingUnit.h
+*	@author Brian Marks
+*	@version 1.1
+*	@details Class declaration for a simulated paging unit: a per-process page table for each process, a shared pool
+*	of physical frames, and a translation lookaside buffer (TLB). Pages are loaded on demand; a process touching a
+*	page which is not resident takes a page fault, which the caller services with hard drive time.
+*	@note 1.1 update chooses victim frames by a pluggable replacement policy and keeps fault statistics per process
+*	@date Sunday, April 29, 2018
+*/
+
+//
+// Compiler Guards ////////////////////////
+//
+#ifndef PAGINGUNIT_H
+#define PAGINGUNIT_H
+
+//
+// Header Files ///////////////////////////
+//
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <pthread.h>
+#include "PageReplacer.h"
+#include "Trace.h"
+
+extern Trace trace;
+
+//
+// Class Declaration ///////////////////////////
+//
+class PagingUnit {
+public:
+	// Constructor/Destructor
+	PagingUnit();
+	~PagingUnit();
+
+	// Initialization functions
+	void Initialize(unsigned long frameCount, unsigned long frameSize, unsigned int tlbSize, unsigned int window);
+	void SetReplacementPolicy(std::string code) throw(std::logic_error);
+
+	// Paging functions
+	unsigned long AllocatePage(int processID);
+	void FreePage(int processID, unsigned long address) throw(std::logic_error);
+	unsigned int Access(int processID, unsigned int accesses, const std::vector<unsigned long> &trace) throw(std::logic_error);
+	void ReleasePages(int processID);
+
+	// Accessors
+	std::string Report();
+	std::string ProcessReport(int processID);
+
+private:
+	// One entry of a page table
+	struct PageTableEntry {
+		PageTableEntry() : frame(0), present(false), allocated(true) {};
+
+		unsigned long frame;		// Frame holding the page, if present
+		bool present;				// true while the page is resident in a frame
+		bool allocated;				// false once the process frees the page; its address is not reused
+	};
+
+	// One physical frame
+	struct Frame {
+		Frame() : owner(-1), page(0) {};
+
+		int owner;					// Process whose page the frame holds, or -1 if free
+		unsigned long page;			// Page the frame holds
+	};
+
+	// Paging statistics of one process. The working set is the set of distinct pages touched in the last
+	// window accesses; a reference count per page keeps its size current in O(1) per access.
+	struct ProcessStats {
+		ProcessStats() : accesses(0), faults(0), evictions(0), workingSet(0), peakWorkingSet(0), workingSetTotal(0) {};
+
+		unsigned long accesses;
+		unsigned long faults;
+		unsigned long evictions;						// Pages of this process evicted by any process
+		unsigned long workingSet;
+		unsigned long peakWorkingSet;
+		unsigned long long workingSetTotal;			// Sum of the working set size after each access, for the mean
+		std::vector<unsigned long> recent;			// Ring of the last window pages touched
+		std::vector<unsigned int> references;		// Times each page appears in recent
+	};
+
+	// One TLB entry; the TLB is fully associative, tagged with the process ID, and replaces its least recently used entry
+	struct TLBEntry {
+		TLBEntry() : processID(-1), page(0), frame(0), lastUse(0) {};
+
+		int processID;				// Process owning the translation, or -1 if invalid
+		unsigned long page;
+		unsigned long frame;
+		unsigned long lastUse;
+	};
+
+	// Not copyable
+	PagingUnit(const PagingUnit&);
+	PagingUnit& operator=(const PagingUnit&);
+
+	// Private functions
+	std::vector<PageTableEntry>& GetPageTable(int processID);
+	bool LookupTLB(int processID, unsigned long page, unsigned long &frame);
+	void FillTLB(int processID, unsigned long page, unsigned long frame);
+	void InvalidateTLB(int processID, unsigned long page);
+	unsigned long LoadPage(int processID, unsigned long page);
+	void RecordAccess(ProcessStats &stats, unsigned long page);
+	void UnloadPage(int processID, unsigned long page);
+
+	// Address translation
+	std::vector<std::vector<PageTableEntry> > pageTables;		// Indexed by process ID
+	std::vector<unsigned int> nextAccess;						// Page each process touches next, without a trace
+	std::vector<unsigned long> allocatedPages;					// Pages each process has allocated and not freed
+	std::vector<TLBEntry> tlb;
+	unsigned long tlbClock;
+
+	// Physical memory
+	unsigned long pageSize;
+	std::vector<Frame> frames;
+	std::vector<unsigned long> freeFrames;
+	PageReplacer replacer;
+
+	// Statistics
+	std::vector<ProcessStats> processStats;					// Indexed by process ID
+	unsigned int workingSetWindow;
+	unsigned long tlbHits;
+	unsigned long tlbMisses;
+	unsigned long pageFaults;
+	unsigned long evictions;
+
+	pthread_mutex_t pagingMutex;		// Cores translate concurrently
+};
+
+#endif	// !PAGINGUNIT_H
@@ -23,10 +23,12 @@
 //
 // Header Files ////////////////////////////////////////
 //
+#include <algorithm>
 #include <stdlib.h>
 #include <time.h>
 #include "ProcessControlBlock.h"
 #include "Config.h"
+#include "Profiler.h"
 
 // Forward declaration of state of process type
 typedef ProcessControlBlock::State State;
@@ -58,79 +60,158 @@ void ProcessControlBlock::changeState(State newState){
 }
 
 /** Run Process
-*	\n Executes the process from beginning to end
+*	\n Executes the process in real time from its current operation until it either blocks on I/O or finishes.
+*	I/O operations are handed to the resource manager to complete asynchronously; the process is left
+*	WAITING and gives up the processor until the I/O completion moves it back to READY. A process waiting on memory
+*	likewise gives up the processor until memory is released.
 *	@pre OperationsQueue must be filled with operations for the process to complete.
+*	@return WAITING if the process blocked on I/O or memory, EXIT if the process has completed every operation
 */
-bool ProcessControlBlock::run(ResourceManager &rm){
+State ProcessControlBlock::run(ResourceManager &rm){
+	for (;;) {
+		Await step = resume(rm);
+
+		if (step.kind == Await::CPU) {
+			PROFILE_ZONE("operation run");
+			void* runningTime = (void*)step.duration;				// Explicitly cast run time to (void*)
+			uSleepThread(runningTime);								// Sleep for as long as necessary
+			endOperation();
+		}
+		else if (step.kind == Await::IO) {
+			// Yield the processor until the I/O completes
+			return WAITING;
+		}
+		else if (step.kind == Await::MEMORY) {
+			// Yield the processor until memory is released
+			return WAITING;
+		}
+		else {
+			return EXIT;
+		}
+	}
+}
+
+/** Resume Process
+*	\n Advances the process' state machine to its next suspension point. Memory allocation completes immediately, or
+*	suspends the process until memory is released, when the allocation is retried;
+*	processing and memory blocking operations are started and suspend the process on the processor; I/O operations
+*	are started and suspend the process until the I/O completes. The caller decides how time passes.
+*	@pre OperationsQueue must be filled with operations for the process to complete.
+*	@return what the process is waiting on, and for how long it occupies the processor
+*/
+ProcessControlBlock::Await ProcessControlBlock::resume(ResourceManager &rm){
 	Operation* anOp;
 
 	// Loop through all processes that need to be completed, in order
-	for (unsigned int i = 0; i < OperationsQueue.size(); i++) {
-		anOp = &OperationsQueue[i];
+	while (programCounter < OperationsQueue.size()) {
+		anOp = &OperationsQueue[programCounter++];
+		PROFILE_ZONE_DETAIL("operation", anOp->descriptor);
+
+		// An operation resumed after a memory wait or page in keeps the sampling decision it started with
+		if (!awaitingMemory && !pagesLoaded) {
+			logger.sampleOperation(processID);
+		}
 
-		// Create a thread if the operation is for I/O
+		// Start asynchronous I/O if the operation is for I/O
 		if (anOp->code == 'I' || anOp->code == 'O') {
-			pthread_t ioThread;
+			DeviceQueue::Request request(processID, anOp->cylinder, 0);
+			int device = rm.FindDevice(anOp->descriptor);
+			unsigned int deviceIndex = 0;
+			if (device < 0) {
+				throw std::logic_error("Meta-Data names a device the system does not have; check configuration file.");
+			}
+			const Config::DeviceSpec &spec = rm.GetDevice(device);
 			// Set process to WAITING
 			processState = WAITING;
 
 			// Wait for the thread to be free
-			while (lock.TestAndSetMutex() == 1);
+			lock.LockMutex();
 
 				// CRITICAL SECTION
 
-				// Log differs based on device
-				if (anOp->descriptor == "projector"){
-					unsigned int projectorIndex = rm.CheckSetProjector();
-					lock.TestAndSetProjector(projectorIndex);
-					// Log: Process (pid): start (anOp->descriptor) (anOp->type) on PROJ (rm.CheckSetProjector)
-					logger.writeWithTimestamp("Process " + std::to_string(processID + 1) + ": start " + anOp->descriptor 
-												+ anOp->type + " on PROJ " + std::to_string(projectorIndex));
-					lock.UnlockProjector(projectorIndex);
-				}
-				else if (anOp->descriptor == "hard drive") {
-					unsigned int hardDriveIndex = rm.CheckSetHardDrive();
-					lock.TestAndSetHardDrive(hardDriveIndex);
-					// Log: Process (pid): start (anOp->descriptor) (anOp->type) on HDD (rm.CheckSetHardDrive)
-					logger.writeWithTimestamp("Process " + std::to_string(processID + 1) + ": start " + anOp->descriptor
-						+ anOp->type + " on HDD " + std::to_string(hardDriveIndex));
-					lock.UnlockHardDrive(hardDriveIndex);
+				long runTime = getRunTimeInMilliSeconds(*anOp);				// Get run time for operation in milliseconds
+				runTime = runTime * 1000;									// Convert to microseconds
+				runTime = spec.SampleServiceTime(runTime, anOp->time, random);	// Draw from the device's service-time model
+				request.serviceTime = runTime;
+				request.description = anOp->descriptor + anOp->type;
+
+				// Devices with units log the unit chosen
+				if (spec.queue != Config::DeviceSpec::SHARED) {
+					deviceIndex = rm.CheckSetDevice(device, runTime);
+					// Log: Process (pid): start (anOp->descriptor) (anOp->type) on (label) (rm.CheckSetDevice)
+					logger.writeOperationOn(processID, request.description, spec.label, deviceIndex);
 				}
 				else {
 					// Log: Process (pid): start (anOp->descriptor) (anOp->type)
-					logger.writeWithTimestamp("Process " + std::to_string(processID + 1) + ": start " + anOp->descriptor + anOp->type);
+					logger.writeOperation(EventLog::OPERATION_START, processID, request.description);
 				}
 
-				long runTime = getRunTimeInMilliSeconds(*anOp);				// Get run time for operation in milliseconds
-				runTime = runTime * 1000;									// Convert to microseconds
-				void* runningTime = (void*)runTime;							// Explicitly cast run time to (void*)
-				pthread_create(&ioThread, NULL, uSleepThread, runningTime);
+				// The resource manager logs the end of the I/O and wakes this process
+				try {
+					rm.StartIO(device, deviceIndex, request);
+				}
+				catch (std::logic_error&) {
+					lock.UnlockMutex();
+					throw;
+				}
 
 			// Unlock the thread
 			lock.UnlockMutex();
 
-			pthread_join(ioThread, NULL);
-			
-			// Log: Process (pid): end (anOp->descriptor) (anOp->type)
-			logger.writeWithTimestamp("Process " + std::to_string(processID+1) + ": end " + anOp->descriptor + anOp->type);
-
-			// Set back to RUNNING
-			processState = RUNNING;
+			return Await(Await::IO, 0);
 		}
-		// Otherwise just run the operation
+		// Memory allocation and freeing take no processor time
+		else if (anOp->code == 'M' && (anOp->descriptor == "allocate" || anOp->descriptor == "free")) {
+			if (!HandleMemoryOperation(*anOp, rm)) {
+				// Retry the allocation once memory is released
+				programCounter--;
+				processState = WAITING;
+				return Await(Await::MEMORY, 0);
+			}
+		}
+		// Otherwise start the operation on the processor
 		else{
-			RunOperation(*anOp, rm);
+			// With paging, memory blocking first faults in any pages it touches which are not resident
+			if (anOp->code == 'M' && rm.IsPaging()) {
+				if (!pagesLoaded) {
+					unsigned int faults = rm.AccessPages(processID, anOp->time, anOp->pages);
+					if (faults > 0) {
+						// Run the operation once the pages are in
+						pagesLoaded = true;
+						programCounter--;
+						return StartPageIn(faults, rm);
+					}
+				}
+				pagesLoaded = false;
+			}
+			return StartOperation(*anOp);
 		}
 	}
 	
-	// Unlock deallocated memory
-	for (unsigned int i = 0; i < allocatedMemoryIndices.size(); i++) {
-		lock.UnlockMemory(allocatedMemoryIndices[i]);
-	}
-	
+	// Unlock memory the process never freed
+	ReportLeaks();
+	rm.ReleaseMemory(processID, allocatedAddresses);
+	allocatedAddresses.clear();
+
 
 	// Process executed successfully!
-	return true;
+	processState = EXIT;
+	return Await(Await::DONE, 0);
+}
+
+/** End Operation
+*	\n Logs the end of the processing or memory blocking operation most recently started by resume().
+*/
+void ProcessControlBlock::endOperation(){
+	const Operation &operation = OperationsQueue[programCounter - 1];
+
+	if (operation.code == 'M') {
+		logger.writeOperation(EventLog::OPERATION_END, processID, "memory blocking");
+	}
+	else {
+		// Log: (ts) Process (pid): end (operation)
+		logger.writeOperation(EventLog::OPERATION_END, processID, operation.type);
+	}
 }
 
 /** Add Operation
@@ -142,6 +223,13 @@ void ProcessControlBlock::addOperation(Operation& newOp){
 	if (newOp.code == 'I' || newOp.code == 'O') {
 		numIO++;
 	}
+	if (newOp.code == 'M' && newOp.descriptor == "allocate") {
+		memoryPlanned++;
+		memoryClaim = std::max(memoryClaim, memoryPlanned);
+	}
+	if (newOp.code == 'M' && newOp.descriptor == "free") {
+		memoryPlanned -= std::min(memoryPlanned, (unsigned int)std::max(newOp.time, 0));
+	}
 	numOps++;
 }
 
@@ -152,6 +240,14 @@ void ProcessControlBlock::setScheduled(){
 	scheduled = true;
 }
 
+/**	Reseed
+*	\n Restarts the process' random stream from a new seed, before it runs.
+*	@param seed is the seed shared by every process of the run; each process draws its own stream of it
+*/
+void ProcessControlBlock::reseed(uint64_t seed){
+	random.Seed(seed, processID);
+}
+
 /** Get PID
 *	\n Process ID accessor.
 *	@return process ID.
@@ -167,7 +263,7 @@ int ProcessControlBlock::getPID() const{
 *	@return the run time in milliseconds for the given operation.
 */
 long ProcessControlBlock::getRunTimeInMilliSeconds(Operation operation) const{
-	return operation.time * conf.GetOperationTime(operation.code, operation.descriptor);
+	return conf.GetServiceTime(operation.code, operation.descriptor, operation.time);
 }
 
 /**	Get State
@@ -228,6 +324,15 @@ unsigned int ProcessControlBlock::getNumOps() const{
 	return numOps;
 }
 
+/**	Get Memory Claim
+*	\n Getter function for the most memory blocks the process holds at once, counting the blocks its M{free} operations
+*	release before later allocations.
+*	@return the peak number of memory blocks the process holds at once.
+*/
+unsigned int ProcessControlBlock::getMemoryClaim() const{
+	return memoryClaim;
+}
+
 /**	Get Scheduled State
 *	\n Getter function which says whether or not the process has been placed onto the schedule.
 *	@return the scheduling status of the process.
@@ -236,58 +341,119 @@ bool ProcessControlBlock::getScheduledState() const{
 	return scheduled;
 }
 
-/** Run Operation
-*	\n Run one operation (simulation).
-*	@param operation to be run
+/** Start Operation
+*	\n Starts one processing or memory blocking operation (simulation).
+*	@param operation to be started
+*	@return the time the operation occupies the processor
 */
-void ProcessControlBlock::RunOperation(Operation operation, ResourceManager &rm){
-
-	if (operation.type == "memory allocated at ") {
-		HandleMemoryOperation(operation, rm);
+ProcessControlBlock::Await ProcessControlBlock::StartOperation(const Operation &operation){
+	if (operation.code == 'M') {
+		logger.writeOperation(EventLog::OPERATION_START, processID, "memory blocking");
 	}
 	else {
 		// Log: (ts) Process (pid): start (operation)
-		logger.writeWithTimestamp("Process " + std::to_string(processID+1) + ": start " + operation.type);
-
-		// Sleep for required time
-		long runTime = getRunTimeInMilliSeconds(operation);		// Get run time for operation in milliseconds
-		runTime = runTime * 1000;								// Convert to microseconds
-		void* runningTime = (void*)runTime;						// Explicitly cast run time to (void*)
-		uSleepThread(runningTime);								// Sleep for as long as necessary
+		logger.writeOperation(EventLog::OPERATION_START, processID, operation.type);
+	}
 
-		// Log: (ts) Process (pid): start (operation)
-		logger.writeWithTimestamp("Process " + std::to_string(processID+1) + ": end " + operation.type);
+	long runTime = getRunTimeInMilliSeconds(operation);		// Get run time for operation in milliseconds
+	return Await(Await::CPU, runTime * 1000);				// Convert to microseconds
+}
 
+/**	Start Page In
+*	\n Services page faults by reading the faulted pages from a hard drive, one hard drive cycle per page. The process waits on
+*	the read like any other I/O.
+*	@param faults is the number of pages to read
+*	@param rm is the resource manager owning the hard drives
+*	@return an I/O wait
+*/
+ProcessControlBlock::Await ProcessControlBlock::StartPageIn(unsigned int faults, ResourceManager &rm){
+	long runTime = faults * conf.GetOperationTime('I', "hard drive") * 1000;		// Convert to microseconds
+	DeviceQueue::Request request(processID, 0, runTime);
+	request.description = "page in";
+	processState = WAITING;
+
+	lock.LockMutex();
+	unsigned int device = rm.FindDevice("hard drive");
+	unsigned int deviceIndex = rm.CheckSetDevice(device, runTime);
+	// Log: Process (pid): start page in on HDD (rm.CheckSetDevice)
+	logger.writeOperationOn(processID, request.description, rm.GetDevice(device).label, deviceIndex);
+	try {
+		rm.StartIO(device, deviceIndex, request);
 	}
+	catch (std::logic_error&) {
+		lock.UnlockMutex();
+		throw;
+	}
+	lock.UnlockMutex();
+
+	return Await(Await::IO, 0);
 }
 
 /**	Handle Memory Operation
-*	\n Handles operations on memory. Sets a random memory addresss when allocating memory.
+*	\n Handles memory allocation. Sets a random memory addresss when allocating memory.
 *	@param operation to be run
+*	@return true if the allocation completed, false if the process must wait for memory to be released
 */
-void ProcessControlBlock::HandleMemoryOperation(Operation operation, ResourceManager &rm){
+bool ProcessControlBlock::HandleMemoryOperation(Operation operation, ResourceManager &rm){
 	if (operation.descriptor == "allocate") {
-		logger.writeWithTimestamp("Process " + std::to_string(processID + 1) + ": allocating memory" );
+		if (!awaitingMemory) {
+			logger.writeProcessText(Log::RESOURCE, processID, "allocating memory");
+		}
 
-		unsigned long address = rm.CheckSetMemory();
-		// Save index of allocated memory block
-		allocatedMemoryIndices.push_back(address / rm.GetBlockSize());
+		// Pages are loaded when touched, so allocating one never waits
+		unsigned long address;
+		if (rm.IsPaging()) {
+			address = rm.AllocatePage(processID);
+		}
+		else {
+			// The resource manager wakes the process to try again if no block can be granted
+			awaitingMemory = !rm.CheckSetMemory(processID, address);
+			if (awaitingMemory) {
+				logger.writeProcessText(Log::DEBUG, processID, "waiting for memory");
+				return false;
+			}
+		}
+		// Save address of allocated memory
+		allocatedAddresses.push_back(address);
 
 		// Log: (ts) Process (pid): (operation.type) 0x(address::hex)
-		logger.writeWithAddress("Process " + std::to_string(processID+1) + ": " + operation.type + "0x", address);
+		logger.writeWithAddress(processID, operation.type, address);
 
 	}
-	else {
+	// M{free}n frees the n most recent allocations still held
+	else if (operation.descriptor == "free") {
+		if ((unsigned int)operation.time > allocatedAddresses.size()) {
+			throw std::logic_error("Process " + std::to_string(processID + 1) + " frees more memory than it holds; check Meta-Data file.");
+		}
+		for (int i = 0; i < operation.time; i++) {
+			unsigned long address = allocatedAddresses.back();
+			rm.FreeMemory(processID, address);
+			allocatedAddresses.pop_back();
 
-		logger.writeWithTimestamp("Process " + std::to_string(processID+1) + ": start memory blocking");
+			// Log: (ts) Process (pid): memory freed at 0x(address::hex)
+			logger.writeWithAddress(processID, "memory freed at ", address);
+		}
+	}
+	return true;
+}
 
-		// Sleep for required time
-		long runTime = getRunTimeInMilliSeconds(operation);		// Get run time for operation in milliseconds
-		runTime = runTime * 1000;								// Convert to microseconds
-		void* runningTime = (void*)runTime;						// Explicitly cast run time to (void*)
-		uSleepThread(runningTime);								// Sleep for as long as necessary
+/**	Report Leaks
+*	\n Logs the memory a process is still holding as it exits, which the operating system then reclaims.
+*/
+void ProcessControlBlock::ReportLeaks(){
+	if (allocatedAddresses.empty() || !logger.isEnabled(Log::LIFECYCLE)) {
+		return;
+	}
 
-		logger.writeWithTimestamp("Process " + std::to_string(processID+1) + ": end memory blocking");
+	// Log: (ts) Process (pid): (n) memory block(s) never freed, reclaimed at exit: 0x(address::hex) ...
+	std::string leaks;
+	EventLog::AppendNumber(leaks, allocatedAddresses.size());
+	leaks += (allocatedAddresses.size() == 1 ? " memory block" : " memory blocks");
+	leaks += " never freed, reclaimed at exit:";
+	for (unsigned int i = 0; i < allocatedAddresses.size(); i++) {
+		leaks += " 0x";
+		EventLog::AppendHex(leaks, allocatedAddresses[i], 8);
 	}
+	logger.writeProcessText(Log::LIFECYCLE, processID, leaks);
 }
 
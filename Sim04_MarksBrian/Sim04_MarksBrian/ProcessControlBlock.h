@@ -1,10 +1,11 @@
 /**
 *	@file ProcessControlBlock.h
 *	@author Brian Marks
-*	@version 1.4
+*	@version 1.5
 *	@details Class definition for the process control block which handles process information and control.
 *	@date Wednesday, April 18, 2018
 *	@note 1.4 update introduces process scheduling control data
+*	@note 1.5 update gives each process its own random stream, for stochastic service times
 */
 
 //
@@ -24,6 +25,7 @@
 #include "Log.h"
 #include "Lock.h"
 #include "ResourceManager.h"
+#include "Random.h"
 
 extern Config conf;		// Forward declaration of global Config item initialized in main 
 extern Log logger;		// Forward declaration of global log initialized in main
@@ -47,13 +49,13 @@ public:
 	// Struct for information about individual operations within this process
 	struct Operation {
 		// Parameterized constructor
-		Operation(char opCode, std::string opDescription, int cycleTime)
-			: code(opCode), descriptor(opDescription), time(cycleTime) {
+		Operation(char opCode, std::string opDescription, int cycleTime, int opCylinder = 0)
+			: code(opCode), descriptor(opDescription), time(cycleTime), cylinder(opCylinder) {
 			codeToType();
 		};
 
 		// Copy constructor
-		Operation(const Operation& other) :code(other.code), descriptor(other.descriptor), time(other.time) { codeToType(); };
+		Operation(const Operation& other) :code(other.code), descriptor(other.descriptor), time(other.time), cylinder(other.cylinder), pages(other.pages) { codeToType(); };
 
 		void codeToType() {
 			switch (code) {
@@ -84,16 +86,36 @@ public:
 		std::string type;
 		std::string descriptor;
 		int time;
+		int cylinder;
+		std::vector<unsigned long> pages;	// Pages touched by memory blocking, in order; empty to touch every page in turn
+	};
+
+	// What a suspended process is waiting on; each call to resume() runs the process up to its next Await
+	struct Await {
+		enum Kind {
+			CPU,		// Occupying the processor for duration
+			IO,			// Blocked until its I/O request completes
+			MEMORY,		// Blocked until memory is released
+			DONE		// Every operation has completed
+		};
+
+		Await(Kind awaitKind, long awaitDuration) : kind(awaitKind), duration(awaitDuration) {};
+
+		Kind kind;
+		long duration;		// Time (us) the processor is occupied
 	};
 
 	// Constructors
-	ProcessControlBlock(int pid) : processID(pid), numIO(0), numOps(0), processState(ProcessControlBlock::START), scheduled(false) {};
+	ProcessControlBlock(int pid) : processID(pid), numIO(0), numOps(0), memoryClaim(0), memoryPlanned(0), processState(ProcessControlBlock::START), programCounter(0), scheduled(false), awaitingMemory(false), pagesLoaded(false), random(conf.randomSeed, pid) {};
 
 	// Member functions
 	void changeState(State newState);
-	bool run(ResourceManager &rm);
+	State run(ResourceManager &rm);
+	Await resume(ResourceManager &rm);
+	void endOperation();
 	void addOperation(Operation &newOp);
 	void setScheduled();
+	void reseed(uint64_t seed);
 	
 	// Accessors
 	int getPID() const;
@@ -103,22 +125,31 @@ public:
 	void printOperationsQueue() const;
 	unsigned int getNumIO() const;
 	unsigned int getNumOps() const;
+	unsigned int getMemoryClaim() const;
 	bool getScheduledState() const;
 
 private:
 
 	// Private functions
-	void RunOperation(Operation operation, ResourceManager &rm);
-	void HandleMemoryOperation(Operation operation, ResourceManager &rm);
+	Await StartOperation(const Operation &operation);
+	Await StartPageIn(unsigned int faults, ResourceManager &rm);
+	bool HandleMemoryOperation(Operation operation, ResourceManager &rm);
+	void ReportLeaks();
 
 	// Private data
 	int processID;
 	int numIO;
 	int numOps;
+	unsigned int memoryClaim;			// Most memory blocks the process holds at once
+	unsigned int memoryPlanned;			// Memory blocks held after the operations added so far
 	State processState;
+	unsigned int programCounter;		// Index of the next operation to run
 	std::vector<Operation> OperationsQueue;
-	std::vector<long> allocatedMemoryIndices;
+	std::vector<unsigned long> allocatedAddresses;	// Memory held, oldest allocation first; freed from the back
 	bool scheduled;
+	bool awaitingMemory;				// true while an allocation is waiting for memory to be released
+	bool pagesLoaded;					// true once the pages faulted by the next memory blocking operation have been read in
+	Random random;						// Draws the process' stochastic service times, in the order of its operations
 };
 
 #endif // !PROCESSCONTROLBLOCK_H
\ No newline at end of file
@@ -0,0 +1,190 @@
+/**
+*	@file Profiler.cpp
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class implementation for the hot-path profiler. Compiled to nothing unless SIM_PROFILE is defined.
+*	@date Monday, April 30, 2018
+*/
+
+//
+// Header Files ///////////////////////////
+//
+#include "Profiler.h"
+
+#ifdef SIM_PROFILE
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <vector>
+#include <pthread.h>
+
+//
+// Thread Buffers ///////////////////////////
+//
+
+namespace {
+
+// One finished zone
+struct Event {
+	const char* name;
+	const char* detail;
+	uint64_t start;
+	uint64_t duration;
+};
+
+// Zones recorded by one thread, kept after the thread exits until they are exported
+struct ThreadBuffer {
+	unsigned int id;
+	std::vector<Event> events;
+	std::set<std::string> strings;			// Interned zone details; set nodes never move
+};
+
+// Totals for one zone name
+struct Counter {
+	Counter() : count(0), total(0), longest(0) {};
+
+	unsigned long count;
+	uint64_t total;
+	uint64_t longest;
+};
+
+pthread_mutex_t registryMutex = PTHREAD_MUTEX_INITIALIZER;
+std::vector<ThreadBuffer*> registry;
+thread_local ThreadBuffer* current = NULL;
+
+/**	Get Buffer
+*	\n Finds the calling thread's buffer, registering one the first time the thread records a zone.
+*	@return the calling thread's buffer
+*/
+ThreadBuffer& GetBuffer() {
+	if (current == NULL) {
+		current = new ThreadBuffer;
+		current->events.reserve(4096);
+		pthread_mutex_lock(&registryMutex);
+		current->id = registry.size();
+		registry.push_back(current);
+		pthread_mutex_unlock(&registryMutex);
+	}
+	return *current;
+}
+
+/**	Write String
+*	\n Writes a string as a JSON string literal.
+*	@param out is the stream written to
+*	@param text is the string written
+*/
+void WriteString(std::ostream &out, const char* text) {
+	out << '"';
+	for (; *text != '\0'; text++) {
+		if (*text == '"' || *text == '\\') {
+			out << '\\';
+		}
+		out << *text;
+	}
+	out << '"';
+}
+
+}
+
+//
+// Class Function Definitions /////////////////
+//
+
+/**	Record
+*	\n Adds a finished zone to the calling thread's buffer.
+*	@param name is the name of the zone
+*	@param detail names what the zone worked on, or NULL
+*	@param start is when the zone began, from Now()
+*	@param end is when the zone ended, from Now()
+*/
+void Profiler::Record(const char* name, const char* detail, uint64_t start, uint64_t end) {
+	Event event;
+	event.name = name;
+	event.detail = detail;
+	event.start = start;
+	event.duration = end - start;
+	GetBuffer().events.push_back(event);
+}
+
+/**	Intern
+*	\n Keeps a copy of a zone detail which lives until the zones are exported.
+*	@param text is the detail
+*	@return the kept copy
+*/
+const char* Profiler::Intern(const std::string &text) {
+	return GetBuffer().strings.insert(text).first->c_str();
+}
+
+/**	Export
+*	\n Writes every recorded zone as Chrome trace-event JSON, and shows the count, total, mean and longest time of each
+*	zone name.
+*	@pre Every thread which recorded zones must have finished recording.
+*	@param path is the trace file written
+*	@throw the trace file cannot be written
+*/
+void Profiler::Export(std::string path) throw(std::logic_error) {
+	std::ofstream fout(path.c_str());
+	std::map<std::string, Counter> counters;
+	uint64_t origin = UINT64_MAX;
+	bool first = true;
+
+	if (!fout.good()) {
+		throw std::logic_error("Profiler trace file could not be written.");
+	}
+
+	pthread_mutex_lock(&registryMutex);
+	for (unsigned int t = 0; t < registry.size(); t++) {
+		if (!registry[t]->events.empty() && registry[t]->events.front().start < origin) {
+			origin = registry[t]->events.front().start;
+		}
+	}
+
+	fout << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n" << std::fixed << std::setprecision(3);
+	for (unsigned int t = 0; t < registry.size(); t++) {
+		const ThreadBuffer &buffer = *registry[t];
+
+		fout << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.id
+			<< ",\"args\":{\"name\":\"" << (buffer.id == 0 ? "main" : "thread " + std::to_string(buffer.id)) << "\"}}";
+		first = false;
+
+		for (unsigned int i = 0; i < buffer.events.size(); i++) {
+			const Event &event = buffer.events[i];
+			// Zones finish innermost first, so their starts are not in order
+			fout << ",\n{\"name\":";
+			WriteString(fout, event.name);
+			fout << ",\"cat\":\"sim\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.id
+				<< ",\"ts\":" << (event.start - origin) / 1000.0 << ",\"dur\":" << event.duration / 1000.0;
+			if (event.detail != NULL) {
+				fout << ",\"args\":{\"detail\":";
+				WriteString(fout, event.detail);
+				fout << "}";
+			}
+			fout << "}";
+
+			Counter &counter = counters[event.name];
+			counter.count++;
+			counter.total += event.duration;
+			if (event.duration > counter.longest) {
+				counter.longest = event.duration;
+			}
+		}
+	}
+	pthread_mutex_unlock(&registryMutex);
+	fout << "\n]}\n";
+
+	// Per-zone counters
+	std::cerr << "Profile written to " << path << std::endl;
+	std::cerr << std::left << std::setw(24) << "zone" << std::right << std::setw(12) << "count" << std::setw(14) << "total ms"
+		<< std::setw(12) << "mean us" << std::setw(12) << "max us" << std::endl;
+	for (std::map<std::string, Counter>::const_iterator i = counters.begin(); i != counters.end(); ++i) {
+		std::cerr << std::left << std::setw(24) << i->first << std::right << std::setw(12) << i->second.count
+			<< std::fixed << std::setprecision(3) << std::setw(14) << i->second.total / 1e6
+			<< std::setw(12) << i->second.total / 1e3 / i->second.count << std::setw(12) << i->second.longest / 1e3 << std::endl;
+	}
+}
+
+#endif	// SIM_PROFILE
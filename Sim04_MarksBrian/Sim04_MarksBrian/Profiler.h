@@ -0,0 +1,82 @@
+/**
+*	@file Profiler.h
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class declaration for the hot-path profiler. Scoped zones record when a phase of the simulator began and
+*	how long it ran into a buffer owned by the recording thread, so recording takes no lock. At exit the zones are
+*	exported as Chrome trace-event JSON, which chrome://tracing and Perfetto both open, along with per-zone counters.
+*	The profiler is compiled in only when SIM_PROFILE is defined; otherwise the zone macros expand to nothing, so
+*	neither the zones nor their arguments cost anything.
+*	@date Monday, April 30, 2018
+*/
+
+//
+// Compiler Guards ////////////////////////
+//
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#ifdef SIM_PROFILE
+
+//
+// Header Files ///////////////////////////
+//
+#include <string>
+#include <stdexcept>
+#include <stdint.h>
+#include <time.h>
+
+//
+// Class Declaration ///////////////////////////
+//
+class Profiler {
+public:
+	// Times the scope it is declared in
+	class Zone {
+	public:
+		Zone(const char* zoneName) : name(zoneName), detail(NULL), start(Now()) {};
+		Zone(const char* zoneName, const std::string &zoneDetail) : name(zoneName), detail(Intern(zoneDetail)), start(Now()) {};
+		~Zone() { Record(name, detail, start, Now()); };
+
+	private:
+		Zone(const Zone&);
+		Zone& operator=(const Zone&);
+
+		const char* name;
+		const char* detail;
+		uint64_t start;
+	};
+
+	// Recording functions
+	static uint64_t Now();
+	static void Record(const char* name, const char* detail, uint64_t start, uint64_t end);
+	static const char* Intern(const std::string &text);
+
+	// Export functions
+	static void Export(std::string path) throw(std::logic_error);
+};
+
+/**	Now
+*	\n Reads the monotonic clock.
+*	@return nanoseconds since an arbitrary fixed point
+*/
+inline uint64_t Profiler::Now() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+// Zone macros: a zone lasts until the end of the enclosing scope
+#define PROFILE_JOIN(a, b) a##b
+#define PROFILE_NAME(line) PROFILE_JOIN(profileZone, line)
+#define PROFILE_ZONE(name) Profiler::Zone PROFILE_NAME(__LINE__)(name)
+#define PROFILE_ZONE_DETAIL(name, detail) Profiler::Zone PROFILE_NAME(__LINE__)(name, detail)
+
+#else
+
+#define PROFILE_ZONE(name)
+#define PROFILE_ZONE_DETAIL(name, detail)
+
+#endif	// SIM_PROFILE
+
+#endif	// !PROFILER_H
@@ -0,0 +1,107 @@
+/**
+*	@file Random.cpp
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class implementation for a seeded pseudo-random number generator (xoshiro256**).
+*	@date Monday, April 30, 2018
+*/
+
+//
+// Header Files ///////////////////////////
+//
+#include "Random.h"
+#include <cmath>
+
+//
+// Class Function Definitions /////////////////
+//
+
+/**	Constructor
+*	\n Creates a generator on the given stream of a seed.
+*	@param seed is the seed of the run
+*	@param stream distinguishes generators sharing a seed, e.g. a process ID
+*/
+Random::Random(uint64_t seed, uint64_t stream) {
+	Seed(seed, stream);
+}
+
+/**	Seed
+*	\n Restarts the generator on the given stream of a seed. The state is expanded from the seed and stream with
+*	SplitMix64, so neighbouring seeds and streams give unrelated sequences.
+*	@param seed is the seed of the run
+*	@param stream distinguishes generators sharing a seed
+*/
+void Random::Seed(uint64_t seed, uint64_t stream) {
+	uint64_t mix = seed;
+	uint64_t streamMix = stream;
+	mix ^= SplitMix(streamMix);
+	for (unsigned int i = 0; i < 4; i++) {
+		state[i] = SplitMix(mix);
+	}
+}
+
+/**	Next
+*	\n Draws the next 64 random bits.
+*	@return the bits
+*/
+uint64_t Random::Next() {
+	uint64_t result = Rotate(state[1] * 5, 7) * 9;
+	uint64_t shifted = state[1] << 17;
+
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= shifted;
+	state[3] = Rotate(state[3], 45);
+
+	return result;
+}
+
+/**	Uniform
+*	\n Draws a number uniformly distributed on [0, 1).
+*	@return the number, with 53 random bits
+*/
+double Random::Uniform() {
+	return (Next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**	Exponential
+*	\n Draws from the exponential distribution with mean 1.
+*	@return the number
+*/
+double Random::Exponential() {
+	return -std::log(1.0 - Uniform());
+}
+
+/**	Normal
+*	\n Draws from the standard normal distribution (Box-Muller). Each draw uses two uniform numbers, so the stream
+*	advances by the same amount every time.
+*	@return the number
+*/
+double Random::Normal() {
+	double radius = std::sqrt(-2.0 * std::log(1.0 - Uniform()));
+	return radius * std::cos(6.283185307179586 * Uniform());
+}
+
+/**	Split Mix
+*	\n Advances a SplitMix64 generator, used to expand a seed into a full state.
+*	@param state is the generator's state, advanced
+*	@return the next 64 bits
+*/
+uint64_t Random::SplitMix(uint64_t &state) {
+	uint64_t result = (state += 0x9E3779B97F4A7C15ULL);
+	result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	result = (result ^ (result >> 27)) * 0x94D049BB133111EBULL;
+	return result ^ (result >> 31);
+}
+
+/**	Rotate
+*	\n Rotates a 64 bit value left.
+*	@param value is the value to rotate
+*	@param bits is the number of bits to rotate by
+*	@return the rotated value
+*/
+uint64_t Random::Rotate(uint64_t value, int bits) {
+	return (value << bits) | (value >> (64 - bits));
+}
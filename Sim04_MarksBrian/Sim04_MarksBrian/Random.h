@@ -0,0 +1,46 @@
+/**
+*	@file Random.h
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class declaration for a seeded pseudo-random number generator (xoshiro256**), used to draw stochastic
+*	service times. Each process draws from its own stream, so a run is reproducible from its seed however the
+*	processes are spread across threads.
+*	@date Monday, April 30, 2018
+*/
+
+//
+// Compiler Guards ////////////////////////
+//
+#ifndef RANDOM_H
+#define RANDOM_H
+
+//
+// Header Files ///////////////////////////
+//
+#include <stdint.h>
+
+//
+// Class Declaration ///////////////////////////
+//
+class Random {
+public:
+	// Constructor
+	Random(uint64_t seed = 0, uint64_t stream = 0);
+
+	// Seeding functions
+	void Seed(uint64_t seed, uint64_t stream);
+
+	// Drawing functions
+	uint64_t Next();
+	double Uniform();
+	double Exponential();
+	double Normal();
+
+private:
+	static uint64_t SplitMix(uint64_t &state);
+	static uint64_t Rotate(uint64_t value, int bits);
+
+	uint64_t state[4];
+};
+
+#endif	// !RANDOM_H
@@ -1,126 +1,522 @@
 #include "ResourceManager.h"
+#include "Profiler.h"
+#include <cerrno>
+#include <time.h>
 
 /**	Constructor
 *	\n Creates a new resource manager object and initializes its counts to 0,
 *	also initializes its resource quantities.
-*	@pre configInfo must be initialized.
+*	@pre conf must be initialized.
 */
 ResourceManager::ResourceManager(){
+	pthread_mutex_init(&deviceMutex, NULL);
+	pthread_mutex_init(&completionMutex, NULL);
+	pthread_cond_init(&completionReady, NULL);
+	pthread_cond_init(&ioThreadsEnded, NULL);
+	pthread_mutex_init(&memoryMutex, NULL);
+	pendingIO = 0;
+	wakeCount = 0;
+	ioThreads = 0;
+	virtualClock = NULL;
+	ioEventCount = 0;
 	initializeResources();
-	projectorCount = 0;
-	hardDriveCount = 0;
 	memoryCount = 0;
 }
 
 /** Initialize Resources
 *	\n Sets the resource quantities for each resource specified in the config file.
-*	@pre configInfo must be initialized.
+*	@pre conf must be initialized.
 */
 void ResourceManager::initializeResources(){
-	// Parse config for resource info
-	for (unsigned int i = 0; i < conf.configInfo.size(); i++) {
-		// System memory
-		if (conf.configInfo[i].first.substr(0, 13) == "system memory") {
-			memory = GetKbytesAvailable(i);
-		}
-		// Block size
-		if (conf.configInfo[i].first.substr(0, 17) == "memory block size") {
-			blockSize = GetKbytesBlock(i);
-		}
-		// Projectors
-		if (conf.configInfo[i].first.substr(0, 18) == "projector quantity") {
-			projectors = conf.configInfo[i].second;
+	// Resource info from the config
+	const Config::ResourceSpec &spec = conf.resources;
+	if (spec.blockBytes == 0) {
+		throw std::logic_error("Could not determine memory block size in kbytes, Mbytes, or Gbytes; Check config file.");
+	}
+	if (spec.Blocks() > UINT_MAX) {
+		throw std::logic_error("System memory holds more blocks than can be simulated; check configuration file.");
+	}
+	memoryBlocks = (unsigned long)spec.Blocks();
+	blockSize = (unsigned long)(spec.blockBytes / 1000);
+
+	// Initialize resource locks
+	std::vector<std::string> deviceNames;
+	std::vector<unsigned int> deviceUnits;
+	for (unsigned int i = 0; i < spec.devices.size(); i++) {
+		deviceNames.push_back(spec.devices[i].name);
+		deviceUnits.push_back(spec.devices[i].quantity);
+	}
+	lock.InitializeLocks(deviceNames, deviceUnits, memoryBlocks);
+
+	// Initialize the resource-allocation graph
+	deadlocks.SetMode(conf.deadlockHandling);
+	deadlocks.SetResources(std::vector<std::string>(1, "memory"), std::vector<unsigned int>(1, memoryBlocks));
+
+	// Initialize memory block ownership
+	blockOwners.assign(memoryBlocks, -1);
+
+	// Initialize paging: each memory block is a frame
+	std::string pagingCode = conf.paging;
+	if (pagingCode != "ON" && pagingCode != "OFF") {
+		throw std::logic_error("Paging code must be ON or OFF; check configuration file.");
+	}
+	paging = (pagingCode == "ON");
+	int hardDrive = spec.FindDeviceIndex("hard drive");
+	if (paging && (hardDrive < 0 || spec.devices[hardDrive].quantity == 0 || spec.devices[hardDrive].queue == Config::DeviceSpec::SHARED)) {
+		throw std::logic_error("Paging requires a hard drive to service page faults; check configuration file.");
+	}
+	pagingUnit.Initialize(memoryBlocks, blockSize, conf.tlbEntries, conf.workingSetWindow);
+	pagingUnit.SetReplacementPolicy(conf.pageReplacement);
+
+	// Initialize device unit status, and the request queue of each unit of a disk scheduled device
+	SetSelectionPolicy(conf.deviceSelection);
+	std::string mergeCode = conf.diskMerging;
+	if (mergeCode != "ON" && mergeCode != "OFF") {
+		throw std::logic_error("Disk merging code must be ON or OFF; check configuration file.");
+	}
+	devices.clear();
+	for (unsigned int i = 0; i < spec.devices.size(); i++) {
+		Device device(spec.devices[i]);
+		device.units.assign(device.spec.quantity, DeviceUnit());
+		if (device.spec.queue == Config::DeviceSpec::DISK) {
+			device.queues.assign(device.spec.quantity, DeviceQueue());
+			device.active.assign(device.spec.quantity, false);
+			device.batches.assign(device.spec.quantity, DeviceQueue::Batch());
+			for (unsigned int unit = 0; unit < device.spec.quantity; unit++) {
+				device.queues[unit].SetDiscipline(device.spec.diskScheduling);
+				device.queues[unit].SetMerging(mergeCode == "ON");
+				device.queues[unit].SetGeometry(device.spec.cylinders, device.spec.seekTime);
+			}
 		}
-		// Hard drives
-		if (conf.configInfo[i].first.substr(0, 19) == "hard drive quantity") {
-			hardDrives = conf.configInfo[i].second;
+		devices.push_back(device);
+	}
+	deviceClock = Timer();				// Resources may be re-initialized; restart the device clock
+	deviceClock.start();
+}
+
+/**	Find Device
+*	\n Looks up a device class by the descriptor naming it in the meta-data. A built-in device configured with a
+*	quantity of 0 has no units, so the machine does not have it.
+*	@param name is the device's meta-data descriptor
+*	@return the number of the device class, or -1 if the machine has no such device
+*/
+int ResourceManager::FindDevice(const std::string &name) const{
+	for (unsigned int i = 0; i < devices.size(); i++) {
+		if (devices[i].spec.name == name) {
+			return (devices[i].units.empty() ? -1 : (int)i);
 		}
 	}
+	return -1;
+}
 
-	// Initialize resource locks
-	lock.InitializeLocks(projectors, hardDrives, memory, blockSize);
+/**	Get Device
+*	\n Getter function for the configuration of a device class.
+*	@param device specifies the device class
+*	@return the device's configuration
+*/
+const Config::DeviceSpec& ResourceManager::GetDevice(unsigned int device) const{
+	return devices[device].spec;
 }
 
-/** Get Available kBytes for memory
-*	\n A getter function for the kBytes available in system memory
-*	@return the amount of space available in kbytes
-*	@pre configInfo must be initialized
-*	@throw couldn't determine space available
+/**	Check and Set Device
+*	\n Selects a unit of a device for a request according to the device selection policy, then marks the request as
+*	outstanding on it. Requests on a SHARED device are served at once on no particular unit.
+*	@param device specifies the device class
+*	@param serviceTime is the time (us) the request will occupy the unit
+*	@return the number of the unit being allocated, or 0 for a SHARED device
 */
-unsigned long ResourceManager::GetKbytesAvailable(unsigned int element) const throw(std::logic_error) {
-	if (conf.configInfo[element].first[15] == 'k') {
-		return conf.configInfo[element].second;
+unsigned int ResourceManager::CheckSetDevice(unsigned int device, long serviceTime){
+	if (devices[device].spec.queue == Config::DeviceSpec::SHARED) {
+		return 0;
 	}
-	else if (conf.configInfo[element].first[15] == 'M') {
-		return (conf.configInfo[element].second * 1000);
+
+	trace.Acquire(&deviceMutex, Trace::DEVICES);
+	unsigned int index = SelectUnit(devices[device], serviceTime);
+	pthread_mutex_unlock(&deviceMutex);
+
+	return index;
+}
+
+/**	Release Device
+*	\n Marks a request on a unit of a device as complete.
+*	@param device specifies the device class
+*	@param index specifies the unit which finished the request
+*/
+void ResourceManager::ReleaseDevice(unsigned int device, unsigned int index){
+	trace.Acquire(&deviceMutex, Trace::DEVICES);
+	ReleaseUnit(devices[device], index);
+	pthread_mutex_unlock(&deviceMutex);
+}
+
+/**	Start I/O
+*	\n Starts an I/O request on a device and returns immediately. The request's process is woken through
+*	TakeCompletions once the request has been serviced. Requests on a DISK device wait on the unit's request queue;
+*	requests on a FIFO device wait for the unit to finish its earlier requests; SHARED devices never make a request wait.
+*	@pre Unless the device is SHARED, CheckSetDevice must have just selected the unit for this request.
+*	@param device specifies the device class servicing the request
+*	@param index specifies the unit of the device (ignored for a SHARED device)
+*	@param request is the request being started
+*	@throw the request names a cylinder which the unit does not have; the unit selected for it is given back
+*/
+void ResourceManager::StartIO(unsigned int device, unsigned int index, DeviceQueue::Request request) throw(std::logic_error){
+	pthread_t ioThread;
+	bool startWorker = false;
+	Device &target = devices[device];
+
+	pthread_mutex_lock(&completionMutex);
+	pendingIO++;
+	pthread_mutex_unlock(&completionMutex);
+
+	// Record how long the request queues behind earlier requests on its unit
+	request.queuedAt = Now();
+	if (target.spec.queue == Config::DeviceSpec::FIFO) {
+		lock.RecordDeviceWait(device, target.units[index].busyUntil - request.serviceTime - request.queuedAt);
+	}
+
+	// In virtual time, completions are events for the caller to advance through
+	if (virtualClock != NULL) {
+		if (target.spec.queue == Config::DeviceSpec::DISK) {
+			try {
+				target.queues[index].Push(request);
+			}
+			catch (std::logic_error&) {
+				UnselectUnit(target, index, request.serviceTime);
+				pthread_mutex_lock(&completionMutex);
+				pendingIO--;
+				pthread_mutex_unlock(&completionMutex);
+				throw;
+			}
+			if (!target.active[index]) {
+				target.active[index] = true;
+				ScheduleBatch(device, index, Now());
+			}
+		}
+		else {
+			bool fifo = (target.spec.queue == Config::DeviceSpec::FIFO);
+			ScheduleIOEvent((fifo ? target.units[index].busyUntil : Now() + request.serviceTime), device, index, request);
+		}
+		return;
 	}
-	else if (conf.configInfo[element].first[15] == 'G') {
-		return (conf.configInfo[element].second * 1000000);
+
+	trace.Acquire(&deviceMutex, Trace::DEVICES);
+	if (target.spec.queue == Config::DeviceSpec::DISK) {
+		try {
+			target.queues[index].Push(request);
+		}
+		catch (std::logic_error&) {
+			UnselectUnit(target, index, request.serviceTime);
+			pthread_mutex_unlock(&deviceMutex);
+			pthread_mutex_lock(&completionMutex);
+			pendingIO--;
+			pthread_mutex_unlock(&completionMutex);
+			throw;
+		}
+		// Only one worker services a unit's queue at a time
+		if (!target.active[index]) {
+			target.active[index] = true;
+			startWorker = true;
+		}
 	}
 	else {
-		throw std::logic_error("Could not determine system memory size in kbytes, Mbytes, or Gbytes; Check config file.");
+		// The request finishes when the unit has worked through everything assigned to it
+		long double finishTime = Now() + request.serviceTime;
+		if (target.spec.queue == Config::DeviceSpec::FIFO) {
+			finishTime = target.units[index].busyUntil;
+		}
+		IOThreadArgs* args = new IOThreadArgs();
+		args->rm = this;
+		args->device = device;
+		args->index = index;
+		args->request = request;
+		args->finishTime = finishTime;
+		ioThreads++;
+		pthread_create(&ioThread, NULL, DeviceWorker, (void*)args);
+		pthread_detach(ioThread);
+	}
+	pthread_mutex_unlock(&deviceMutex);
+
+	if (startWorker) {
+		IOThreadArgs* args = new IOThreadArgs();
+		args->rm = this;
+		args->device = device;
+		args->index = index;
+		ioThreads++;
+		pthread_create(&ioThread, NULL, QueueWorker, (void*)args);
+		pthread_detach(ioThread);
 	}
 }
 
-/** Get Available kBytes for block size
-*	\n A getter function for the size of each block in kbytes
-*	@return the block size in kbytes
-*	@pre configInfo must be initialized
-*	@throw couldn't determine block size
+/**	Take Completions
+*	\n Collects the processes whose I/O has completed since the last call, along with processes woken to retry a memory allocation.
+*	@param processIDs receives the IDs of the processes which may be made READY
 */
-unsigned long ResourceManager::GetKbytesBlock(unsigned int element) const throw(std::logic_error) {
-	if (conf.configInfo[element].first[19] == 'k') {
-		return conf.configInfo[element].second;
+void ResourceManager::TakeCompletions(std::vector<int> &processIDs){
+	pthread_mutex_lock(&completionMutex);
+	processIDs.insert(processIDs.end(), completedIO.begin(), completedIO.end());
+	completedIO.clear();
+	pthread_mutex_unlock(&completionMutex);
+}
+
+/**	Get Wake Count
+*	\n Getter function for the number of completions and wake-ups posted so far. A thread reads it before looking
+*	for work, then passes it to WaitForWake, so nothing posted in between is missed.
+*	@return the number of completions and wake-ups posted
+*/
+unsigned long ResourceManager::GetWakeCount(){
+	pthread_mutex_lock(&completionMutex);
+	unsigned long count = wakeCount;
+	pthread_mutex_unlock(&completionMutex);
+
+	return count;
+}
+
+/**	Wait For Wake
+*	\n Blocks the calling thread until an I/O completes, memory is released, or WakeIdle is called, after the count
+*	given was read.
+*	@param seen is the wake count read by GetWakeCount
+*	@param timeout is the longest time (us) to wait
+*/
+void ResourceManager::WaitForWake(unsigned long seen, long timeout){
+	struct timespec deadline;
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += timeout / 1000000;
+	deadline.tv_nsec += (timeout % 1000000) * 1000;
+	if (deadline.tv_nsec >= 1000000000) {
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000;
 	}
-	else if (conf.configInfo[element].first[19] == 'M') {
-		return (conf.configInfo[element].second * 1000);
+
+	pthread_mutex_lock(&completionMutex);
+	while (wakeCount == seen) {
+		if (pthread_cond_timedwait(&completionReady, &completionMutex, &deadline) == ETIMEDOUT) {
+			break;
+		}
 	}
-	else if (conf.configInfo[element].first[19] == 'G') {
-		return (conf.configInfo[element].second * 1000000);
+	pthread_mutex_unlock(&completionMutex);
+}
+
+/**	Wake Idle
+*	\n Wakes every thread waiting in WaitForWake, for a change they wait on besides completions.
+*/
+void ResourceManager::WakeIdle(){
+	pthread_mutex_lock(&completionMutex);
+	wakeCount++;
+	pthread_cond_broadcast(&completionReady);
+	pthread_mutex_unlock(&completionMutex);
+}
+
+/**	Wait For I/O Threads
+*	\n Waits until every I/O thread has ended. A thread may still be finishing when its request's process is woken,
+*	so this is waited for before the simulation is torn down or a trace of it is finished.
+*/
+void ResourceManager::WaitForIOThreads(){
+	pthread_mutex_lock(&completionMutex);
+	while (ioThreads > 0) {
+		pthread_cond_wait(&ioThreadsEnded, &completionMutex);
 	}
-	else {
-		throw std::logic_error("Could not determine memory block size in kbytes, Mbytes, or Gbytes; Check config file.");
+	pthread_mutex_unlock(&completionMutex);
+}
+
+/**	Get Pending I/O
+*	\n Getter function for the number of I/O requests which have been started but not completed.
+*	@return the number of outstanding I/O requests
+*/
+unsigned int ResourceManager::GetPendingIO(){
+	pthread_mutex_lock(&completionMutex);
+	unsigned int pending = pendingIO;
+	pthread_mutex_unlock(&completionMutex);
+
+	return pending;
+}
+
+/**	Use Virtual Clock
+*	\n Runs the devices in simulated time. I/O started afterwards completes only when the caller advances the clock
+*	past its completion and calls CompleteIOUntil, rather than on I/O threads.
+*	@pre No I/O may be pending.
+*	@param clock points to the simulated time in microseconds, or NULL to return to real time
+*/
+void ResourceManager::UseVirtualClock(const long double* clock){
+	virtualClock = clock;
+}
+
+/**	Next I/O Event
+*	\n Finds the simulated time of the next I/O completion.
+*	@param time receives the simulated time (us) of the next completion
+*	@return true if an I/O completion is pending, false otherwise
+*/
+bool ResourceManager::NextIOEvent(long double &time){
+	if (ioEvents.empty()) {
+		return false;
 	}
+	time = ioEvents.top().time;
+	return true;
 }
 
-/**	Check and Set Projector
-*	\n Checks the current count for projectors in use, then sets the next available projector as in use, then returns the projector number.
-*	When the available projectors are exhausted, the next projector used is projector 0.
-*	@return the number of the projector being allocated
+/**	Complete I/O Until
+*	\n Completes every I/O event due at or before the given simulated time, in time order. A unit of a DISK device which
+*	completes a batch goes on to the next batch in its queue. Woken processes are collected with TakeCompletions.
+*	@param time is the simulated time (us) the clock has advanced to
 */
-unsigned int ResourceManager::CheckSetProjector(){
-	return (projectorCount++ % projectors);
+void ResourceManager::CompleteIOUntil(long double time){
+	while (!ioEvents.empty() && ioEvents.top().time <= time) {
+		IOEvent event = ioEvents.top();
+		ioEvents.pop();
+
+		Device &target = devices[event.device];
+
+		if (target.spec.queue == Config::DeviceSpec::DISK) {
+			DeviceQueue::Batch batch = target.batches[event.index];
+			for (unsigned int i = 0; i < batch.requests.size(); i++) {
+				ReleaseUnit(target, event.index);
+				CompleteIO(batch.requests[i]);
+			}
+			if (target.queues[event.index].Empty()) {
+				target.active[event.index] = false;
+			}
+			else {
+				ScheduleBatch(event.device, event.index, event.time);
+			}
+		}
+		else {
+			if (target.spec.queue == Config::DeviceSpec::FIFO) {
+				ReleaseUnit(target, event.index);
+			}
+			CompleteIO(event.request);
+		}
+	}
 }
 
-/**	Check and Set Hard Drive
-*	\n Checks the current count for hard drives in use, then sets the next available hard drive as in use, then returns the hard drive number.
-*	When the available hard drives are exhausted, the next hard drive used is hard drive 0.
-*	@return the number of the hard drive being allocated
+/**	Declare Memory Claim
+*	\n Records the most memory blocks a process will hold at once, for deadlock avoidance.
+*	@param processID is the process making the claim
+*	@param blocks is the number of blocks the process allocates
+*	@throw in AVOID mode, the process claims more blocks than the system has
 */
-unsigned int ResourceManager::CheckSetHardDrive(){
-	return (hardDriveCount++ % hardDrives);
+void ResourceManager::DeclareMemoryClaim(int processID, unsigned int blocks) throw(std::logic_error){
+	trace.Acquire(&memoryMutex, Trace::MEMORY);
+	try {
+		deadlocks.DeclareClaim(processID, MEMORY_BLOCKS, blocks);
+	}
+	catch (std::logic_error&) {
+		pthread_mutex_unlock(&memoryMutex);
+		throw;
+	}
+	pthread_mutex_unlock(&memoryMutex);
 }
 
 /**	Check and Set Memory
 *	\n Checks the current count for memory blocks in use, then sets the next available memory block as in use, then returns the beginning of the memory block address.
-*	If all memory blocks are locked and in use, this will wait for the next available block to be available, which it will then lock and allocate.
-*	@throw Runtime error is thrown if it takes more than 10 seconds to find an available memory slot. This error is likely a result of 
-*			a single process requiring more memory than the system has. When processes are run concurrently, an exceptionally long process
-*			could also be the cause of this error.
-*	@return the number of the memory block being allocated
+*	If all memory blocks are locked and in use, the process must wait for a block to be released rather than hold its processor: its request is added to the
+*	resource-allocation graph, false is returned, and the process is woken through TakeCompletions when memory is released, to try again.
+*	Under the "Deadlock Handling Code", DETECT fails a request which would deadlock and AVOID also makes a process wait while granting the block would leave
+*	the system unsafe.
+*	@param processID is the process allocating the block
+*	@param address receives the address of the block allocated
+*	@throw Logic error is thrown if the request would deadlock, or exceeds the process' maximum claim.
+*	@return true if a block was allocated, false if the process must wait
 */
-unsigned long ResourceManager::CheckSetMemory() throw (std::runtime_error){
-	Timer searching;
-	searching.start();
-	// Find and lock an available memory address
-	for ( ; lock.TestAndSetMemory(memoryCount); memoryCount++) {
-		// If no available slot has been found after 10 seconds, throw a runtime error
-		if (searching.getElapsedSeconds() > 10) {
-			throw std::runtime_error("Memory allocation time exceeded 10s; One process likely requires memory in excess of what is available in the system.");
+bool ResourceManager::CheckSetMemory(int processID, unsigned long &address) throw (std::logic_error){
+	PROFILE_ZONE("memory allocate");
+	trace.Acquire(&memoryMutex, Trace::MEMORY);
+	try {
+		// Every grant is made under memoryMutex, so a block the graph shows as free can always be reserved
+		if (!deadlocks.CanGrant(processID, MEMORY_BLOCKS) || !lock.ReserveMemory()) {
+			deadlocks.Request(processID, MEMORY_BLOCKS);
+			if (memoryRequested.find(processID) == memoryRequested.end()) {
+				memoryRequested[processID] = Now();
+			}
+			memoryWaiters.push_back(processID);
+			pthread_mutex_unlock(&memoryMutex);
+			return false;
 		}
 	}
-		
-	return ((memoryCount++ * blockSize) % memory);
+	catch (std::logic_error&) {
+		pthread_mutex_unlock(&memoryMutex);
+		throw;
+	}
+	deadlocks.Grant(processID, MEMORY_BLOCKS);
+
+	// Record how long the process waited for the block
+	std::map<int, long double>::iterator requested = memoryRequested.find(processID);
+	if (requested == memoryRequested.end()) {
+		lock.RecordMemoryWait(0);
+	}
+	else {
+		lock.RecordMemoryWait(Now() - requested->second);
+		memoryRequested.erase(requested);
+	}
+
+	// Find and lock the reserved memory block, continuing on from the last block allocated; searching under
+	// memoryMutex makes the block chosen depend only on the order of the allocations, so a trace replays it
+	unsigned long block;
+	do {
+		block = memoryCount++ % memoryBlocks;
+	} while (!lock.TryLockMemory(block));
+
+	blockOwners[block] = processID;
+	pthread_mutex_unlock(&memoryMutex);
+
+	address = block * blockSize;
+	return true;
+}
+
+/**	Free Memory
+*	\n Frees a single memory block or page before its process exits. A freed block wakes every process waiting on memory.
+*	@param processID is the process freeing the memory
+*	@param address is the address returned when the memory was allocated
+*	@throw the process does not hold memory at the address
+*/
+void ResourceManager::FreeMemory(int processID, unsigned long address) throw(std::logic_error){
+	PROFILE_ZONE("memory free");
+	if (paging) {
+		pagingUnit.FreePage(processID, address);
+		return;
+	}
+
+	unsigned long block = address / blockSize;
+	trace.Acquire(&memoryMutex, Trace::MEMORY);
+	if (address % blockSize != 0 || block >= blockOwners.size() || blockOwners[block] != processID) {
+		pthread_mutex_unlock(&memoryMutex);
+		throw std::logic_error("Memory freed which the process does not hold; check Meta-Data file.");
+	}
+	UnlockBlock(processID, block);
+	WakeMemoryWaiters();
+	pthread_mutex_unlock(&memoryMutex);
+}
+
+/**	Release Memory
+*	\n Unlocks memory blocks held by a process, then wakes every process waiting on memory to try its allocation again.
+*	When memory is paged, logs the process' paging statistics and frees its frames instead.
+*	@param processID is the process releasing the blocks
+*	@param addresses are the addresses of the blocks being released
+*/
+void ResourceManager::ReleaseMemory(int processID, const std::vector<unsigned long> &addresses){
+	if (paging) {
+		logger.writeProcessText(Log::LIFECYCLE, processID, pagingUnit.ProcessReport(processID));
+		pagingUnit.ReleasePages(processID);
+		return;
+	}
+
+	trace.Acquire(&memoryMutex, Trace::MEMORY);
+	for (unsigned int i = 0; i < addresses.size(); i++) {
+		UnlockBlock(processID, addresses[i] / blockSize);
+	}
+	if (!addresses.empty()) {
+		WakeMemoryWaiters();
+	}
+	pthread_mutex_unlock(&memoryMutex);
+}
+
+/**	Get Memory Waiting
+*	\n Getter function for the number of processes waiting for memory to be released.
+*	@return the number of processes waiting on memory
+*/
+unsigned int ResourceManager::GetMemoryWaiting(){
+	pthread_mutex_lock(&memoryMutex);
+	unsigned int waiting = memoryWaiters.size();
+	pthread_mutex_unlock(&memoryMutex);
+
+	return waiting;
 }
 
 /**	Get Block Size
@@ -130,3 +526,321 @@ unsigned long ResourceManager::CheckSetMemory() throw (std::runtime_error){
 unsigned long ResourceManager::GetBlockSize(){
 	return blockSize;
 }
+
+/**	Is Paging
+*	\n Getter function for whether memory is paged.
+*	@return true if memory allocations are pages loaded on demand, false if they are physical memory blocks
+*/
+bool ResourceManager::IsPaging() const{
+	return paging;
+}
+
+/**	Allocate Page
+*	\n Adds a page to a process' virtual address space. Pages never wait on physical memory; they compete for frames when touched.
+*	@param processID is the process allocating the page
+*	@return the virtual address of the page
+*/
+unsigned long ResourceManager::AllocatePage(int processID){
+	return pagingUnit.AllocatePage(processID);
+}
+
+/**	Access Pages
+*	\n Touches a process' pages through the TLB and page table, loading pages which are not resident.
+*	@param processID is the process making the accesses
+*	@param accesses is the number of memory accesses
+*	@param trace is the pages to touch, in order, or empty to touch every page in turn
+*	@return the number of page faults, each of which must be serviced by a hard drive
+*	@throw the trace names a page the process has not allocated
+*/
+unsigned int ResourceManager::AccessPages(int processID, unsigned int accesses, const std::vector<unsigned long> &trace) throw(std::logic_error){
+	return pagingUnit.Access(processID, accesses, trace);
+}
+
+/**	Report Paging
+*	\n Logs the TLB hit rate and page fault count, if memory is paged.
+*/
+void ResourceManager::ReportPaging(){
+	if (paging) {
+		logger.writeWithTimestamp("OS: " + pagingUnit.Report());
+	}
+}
+
+/**	Set Selection Policy
+*	\n Translates the "Device Selection Code" from the config file into a selection policy.
+*	@param code is RR (round robin), FF (first free), LQ (least queue depth), or SEC (shortest expected completion)
+*	@throw the code is not a known selection policy
+*/
+void ResourceManager::SetSelectionPolicy(std::string code) throw(std::logic_error){
+	if (code == "RR") {
+		selectionPolicy = ROUND_ROBIN;
+	}
+	else if (code == "FF") {
+		selectionPolicy = FIRST_FREE;
+	}
+	else if (code == "LQ") {
+		selectionPolicy = LEAST_QUEUE;
+	}
+	else if (code == "SEC") {
+		selectionPolicy = SHORTEST_COMPLETION;
+	}
+	else {
+		throw std::logic_error("Device selection code is either incompatible or undefined; check configuration file.");
+	}
+}
+
+/**	Select Unit
+*	\n Chooses a unit of a device according to the selection policy, then records the request against it.
+*	When no unit is idle under FIRST_FREE, the unit which becomes idle the soonest is chosen.
+*	@param device is the device class, whose unit status and round robin counter are updated
+*	@param serviceTime is the time (us) the request will occupy the unit
+*	@return the number of the unit being allocated
+*/
+unsigned int ResourceManager::SelectUnit(Device &device, long serviceTime){
+	std::vector<DeviceUnit> &units = device.units;
+	long double now = Now();
+	unsigned int index = 0;
+
+	if (selectionPolicy == ROUND_ROBIN) {
+		index = device.count++ % units.size();
+	}
+	else if (selectionPolicy == LEAST_QUEUE) {
+		for (unsigned int i = 1; i < units.size(); i++) {
+			if (units[i].queueDepth < units[index].queueDepth ||
+					(units[i].queueDepth == units[index].queueDepth && units[i].busyUntil < units[index].busyUntil)) {
+				index = i;
+			}
+		}
+	}
+	else {
+		for (unsigned int i = 0; i < units.size(); i++) {
+			// First free: take the lowest numbered idle unit
+			if (selectionPolicy == FIRST_FREE && units[i].queueDepth == 0 && units[i].busyUntil <= now) {
+				index = i;
+				break;
+			}
+			// Otherwise the unit which is free the soonest completes the request the soonest
+			if (units[i].busyUntil < units[index].busyUntil ||
+					(units[i].busyUntil == units[index].busyUntil && units[i].queueDepth < units[index].queueDepth)) {
+				index = i;
+			}
+		}
+	}
+
+	// The choice depends on the clock; a replay takes the unit the recording took
+	index = trace.Choose(Trace::DEVICES, index);
+
+	// Record the request against the unit
+	units[index].queueDepth++;
+	units[index].busyUntil = (units[index].busyUntil > now ? units[index].busyUntil : now) + serviceTime;
+
+	return index;
+}
+
+/**	Release Unit
+*	\n Removes a completed request from a unit's outstanding request count.
+*	@param device is the device class
+*	@param index specifies the unit which finished the request
+*/
+void ResourceManager::ReleaseUnit(Device &device, unsigned int index){
+	if (device.units[index].queueDepth > 0) {
+		device.units[index].queueDepth--;
+	}
+}
+
+/**	Unselect Unit
+*	\n Takes back a request which SelectUnit recorded against a unit but which could not be started.
+*	@param device is the device class
+*	@param index specifies the unit the request was recorded against
+*	@param serviceTime is the time (us) the request was to occupy the unit
+*/
+void ResourceManager::UnselectUnit(Device &device, unsigned int index, long serviceTime){
+	ReleaseUnit(device, index);
+	device.units[index].busyUntil -= serviceTime;
+}
+
+/**	Queue Worker
+*	\n A process that can be called in the creation of a thread which services the request queue of a unit of a DISK
+*	device, one batch at a time, until the queue is empty.
+*	@param threadarg is a heap allocated IOThreadArgs naming the unit; it is deleted here
+*/
+void* ResourceManager::QueueWorker(void* threadarg){
+	IOThreadArgs* args = (IOThreadArgs*)threadarg;
+	ResourceManager* rm = args->rm;
+	unsigned int device = args->device;
+	unsigned int index = args->index;
+	Device &target = rm->devices[device];
+	delete args;
+	Trace::SetThread(Trace::UnitThread(device, index));
+
+	for (;;) {
+		trace.Acquire(&rm->deviceMutex, Trace::DEVICES);
+		if (target.queues[index].Empty()) {
+			target.active[index] = false;
+			pthread_mutex_unlock(&rm->deviceMutex);
+			break;
+		}
+		DeviceQueue::Batch batch = target.queues[index].Dispatch();
+		long double startTime = rm->Now();
+		pthread_mutex_unlock(&rm->deviceMutex);
+		rm->RecordBatchWaits(device, batch, startTime);
+
+		// Hold the unit for the duration of the batch
+		lock.LockDevice(device, index);
+		rm->WaitUntil(startTime + batch.serviceTime);
+		lock.UnlockDevice(device, index);
+
+		for (unsigned int i = 0; i < batch.requests.size(); i++) {
+			rm->ReleaseDevice(device, index);
+			rm->CompleteIO(batch.requests[i]);
+		}
+	}
+
+	rm->EndIOThread();
+	return NULL;
+}
+
+/**	Device Worker
+*	\n A process that can be called in the creation of a thread which services one request on a FIFO or SHARED device.
+*	@param threadarg is a heap allocated IOThreadArgs holding the request; it is deleted here
+*/
+void* ResourceManager::DeviceWorker(void* threadarg){
+	IOThreadArgs* args = (IOThreadArgs*)threadarg;
+	ResourceManager* rm = args->rm;
+	Trace::SetThread(Trace::RequestThread(args->request.processID));
+
+	if (args->rm->devices[args->device].spec.queue == Config::DeviceSpec::FIFO) {
+		// Requests on a FIFO unit are serviced back to back; hold it from the start of this one to its end
+		args->rm->WaitUntil(args->finishTime - args->request.serviceTime);
+		lock.LockDevice(args->device, args->index);
+		args->rm->WaitUntil(args->finishTime);
+		lock.UnlockDevice(args->device, args->index);
+		args->rm->ReleaseDevice(args->device, args->index);
+	}
+	else {
+		args->rm->WaitUntil(args->finishTime);
+	}
+	args->rm->CompleteIO(args->request);
+
+	delete args;
+	rm->EndIOThread();
+	return NULL;
+}
+
+/**	End I/O Thread
+*	\n Counts an I/O thread as ended; it must be the thread's last use of the resource manager.
+*/
+void ResourceManager::EndIOThread(){
+	pthread_mutex_lock(&completionMutex);
+	ioThreads--;
+	pthread_cond_broadcast(&ioThreadsEnded);
+	pthread_mutex_unlock(&completionMutex);
+}
+
+/**	Wait Until
+*	\n Sleeps the calling thread until the device clock reaches the given time.
+*	@param deviceTime is the time (us) on the device clock to wake at
+*/
+void ResourceManager::WaitUntil(long double deviceTime){
+	long double remaining = deviceTime - Now();
+	while (remaining > 0) {
+		usleep((useconds_t)remaining);
+		remaining = deviceTime - Now();
+	}
+}
+
+/**	Complete I/O
+*	\n Logs the end of an I/O request, then queues its process to be made READY.
+*	@param request is the request which has been serviced
+*/
+void ResourceManager::CompleteIO(DeviceQueue::Request &request){
+	// Log: Process (pid): end (descriptor) (type)
+	logger.writeOperation(EventLog::OPERATION_END, request.processID, request.description);
+
+	pthread_mutex_lock(&completionMutex);
+	completedIO.push_back(request.processID);
+	pendingIO--;
+	wakeCount++;
+	pthread_cond_broadcast(&completionReady);
+	pthread_mutex_unlock(&completionMutex);
+}
+
+/**	Now
+*	\n Getter function for the current device time.
+*	@return the simulated time (us) if a virtual clock is in use, otherwise the real time (us) since initialization
+*/
+long double ResourceManager::Now(){
+	if (virtualClock != NULL) {
+		return *virtualClock;
+	}
+	return deviceClock.getElapsedMicroSeconds();
+}
+
+/**	Schedule I/O Event
+*	\n Queues an I/O completion in simulated time.
+*	@param time is the simulated time (us) at which the request completes
+*	@param device specifies the device class servicing the request
+*	@param index specifies the unit of the device
+*	@param request is the request which completes
+*/
+void ResourceManager::ScheduleIOEvent(long double time, unsigned int device, unsigned int index, DeviceQueue::Request request){
+	IOEvent event;
+	event.time = time;
+	event.sequence = ioEventCount++;
+	event.device = device;
+	event.index = index;
+	event.request = request;
+	ioEvents.push(event);
+}
+
+/**	Schedule Batch
+*	\n Takes the next batch from the queue of a unit of a DISK device and schedules its completion in simulated time.
+*	@pre The unit's queue must not be empty.
+*	@param device specifies the device class
+*	@param index specifies the unit
+*	@param startTime is the simulated time (us) at which the unit starts the batch
+*/
+void ResourceManager::ScheduleBatch(unsigned int device, unsigned int index, long double startTime){
+	Device &target = devices[device];
+	target.batches[index] = target.queues[index].Dispatch();
+	RecordBatchWaits(device, target.batches[index], startTime);
+	ScheduleIOEvent(startTime + target.batches[index].serviceTime, device, index, DeviceQueue::Request());
+}
+
+/**	Record Batch Waits
+*	\n Records how long each request in a batch queued before its unit started the batch.
+*	@param device specifies the device class
+*	@param batch is the batch being started
+*	@param startTime is the device time (us) at which the unit starts the batch
+*/
+void ResourceManager::RecordBatchWaits(unsigned int device, const DeviceQueue::Batch &batch, long double startTime){
+	for (unsigned int i = 0; i < batch.requests.size(); i++) {
+		lock.RecordDeviceWait(device, startTime - batch.requests[i].queuedAt);
+	}
+}
+
+/**	Unlock Block
+*	\n Returns one memory block to the pool and drops it from the process' allocation in the resource-allocation graph.
+*	@pre memoryMutex must be held, and the process must hold the block.
+*	@param processID is the process releasing the block
+*	@param block is the number of the block
+*/
+void ResourceManager::UnlockBlock(int processID, unsigned long block){
+	blockOwners[block] = -1;
+	lock.UnlockMemory(block);
+	deadlocks.Release(processID, MEMORY_BLOCKS, 1);
+}
+
+/**	Wake Memory Waiters
+*	\n Hands every process waiting on memory to TakeCompletions, so each tries its allocation again.
+*	@pre memoryMutex must be held.
+*/
+void ResourceManager::WakeMemoryWaiters(){
+	if (!memoryWaiters.empty()) {
+		pthread_mutex_lock(&completionMutex);
+		completedIO.insert(completedIO.end(), memoryWaiters.begin(), memoryWaiters.end());
+		wakeCount++;
+		pthread_cond_broadcast(&completionReady);
+		pthread_mutex_unlock(&completionMutex);
+		memoryWaiters.clear();
+	}
+}
@@ -17,43 +17,182 @@
 //
 #include <stdexcept>
 #include <vector>
+#include <queue>
+#include <map>
+#include <atomic>
+#include <climits>
+#include <pthread.h>
+#include <unistd.h>
 #include "Config.h"
 #include "Lock.h"
 #include "Timer.h"
+#include "DeviceQueue.h"
+#include "DeadlockDetector.h"
+#include "PagingUnit.h"
+#include "Log.h"
 
 extern Config conf;
 extern Lock lock;
+extern Log logger;
+extern Trace trace;
 
 //
 // Class Declaration ///////////////////////////
 //
 class ResourceManager{
 public:
+	// Device unit selection policies
+	enum SelectionPolicy {
+		ROUND_ROBIN,			// RR: next unit in turn, regardless of its status
+		FIRST_FREE,				// FF: lowest numbered idle unit
+		LEAST_QUEUE,			// LQ: unit with the fewest outstanding requests
+		SHORTEST_COMPLETION		// SEC: unit which would complete the request the soonest
+	};
+
+	// Status of a single device unit
+	struct DeviceUnit {
+		DeviceUnit() : busyUntil(0), queueDepth(0) {};
+
+		long double busyUntil;		// Time (us) at which all work assigned to the unit is complete
+		unsigned int queueDepth;	// Number of requests assigned to the unit which have not been released
+	};
+
 	// Constructor
 	ResourceManager();
 
 	// Initialization functions
 	void initializeResources();
-	unsigned long GetKbytesAvailable(unsigned int element) const throw(std::logic_error);
-	unsigned long GetKbytesBlock(unsigned int element) const throw(std::logic_error);
 
-	// Accessors
-	unsigned int CheckSetProjector();
-	unsigned int CheckSetHardDrive();
-	unsigned long CheckSetMemory() throw (std::runtime_error);
+	// Device functions
+	int FindDevice(const std::string &name) const;
+	const Config::DeviceSpec& GetDevice(unsigned int device) const;
+	unsigned int CheckSetDevice(unsigned int device, long serviceTime);
+	void ReleaseDevice(unsigned int device, unsigned int index);
+
+	// Asynchronous I/O functions
+	void StartIO(unsigned int device, unsigned int index, DeviceQueue::Request request) throw(std::logic_error);
+	void TakeCompletions(std::vector<int> &processIDs);
+	unsigned long GetWakeCount();
+	void WaitForWake(unsigned long seen, long timeout);
+	void WakeIdle();
+	unsigned int GetPendingIO();
+	void WaitForIOThreads();
+
+	// Virtual time functions
+	void UseVirtualClock(const long double* clock);
+	bool NextIOEvent(long double &time);
+	void CompleteIOUntil(long double time);
+	// Memory functions
+	void DeclareMemoryClaim(int processID, unsigned int blocks) throw(std::logic_error);
+	bool CheckSetMemory(int processID, unsigned long &address) throw (std::logic_error);
+	void FreeMemory(int processID, unsigned long address) throw(std::logic_error);
+	void ReleaseMemory(int processID, const std::vector<unsigned long> &addresses);
+	unsigned int GetMemoryWaiting();
 	unsigned long GetBlockSize();
 
+	// Paging functions
+	bool IsPaging() const;
+	unsigned long AllocatePage(int processID);
+	unsigned int AccessPages(int processID, unsigned int accesses, const std::vector<unsigned long> &trace) throw(std::logic_error);
+	void ReportPaging();
+
 private:
+	// Resources tracked by the deadlock detector
+	enum ResourceClass {
+		MEMORY_BLOCKS
+	};
+
+	// A device class and the status of its units
+	struct Device {
+		Device(const Config::DeviceSpec &deviceSpec) : spec(deviceSpec), count(0) {};
+
+		Config::DeviceSpec spec;
+		std::vector<DeviceUnit> units;
+		unsigned int count;							// Round robin counter
+		std::vector<DeviceQueue> queues;			// Request queue of each unit, for a DISK queue
+		std::vector<bool> active;					// true while a worker thread is servicing the unit's queue
+		std::vector<DeviceQueue::Batch> batches;	// Batch each unit is servicing in virtual time
+	};
+
+	// Arguments handed to an I/O thread
+	struct IOThreadArgs {
+		ResourceManager* rm;
+		unsigned int device;
+		unsigned int index;
+		DeviceQueue::Request request;
+		long double finishTime;			// Device clock time (us) at which the request completes
+	};
+
+	// A request completing in virtual time
+	struct IOEvent {
+		long double time;				// Simulated time (us) at which the request completes
+		unsigned long sequence;			// Order the event was scheduled in, to break ties
+		unsigned int device;
+		unsigned int index;
+		DeviceQueue::Request request;	// Unused for DISK queues, whose units complete the batch they are servicing
+
+		// Orders the earliest event first in a priority queue
+		bool operator<(const IOEvent& other) const {
+			return (time > other.time || (time == other.time && sequence > other.sequence));
+		}
+	};
+
+	// Device selection
+	void SetSelectionPolicy(std::string code) throw(std::logic_error);
+	unsigned int SelectUnit(Device &device, long serviceTime);
+	void ReleaseUnit(Device &device, unsigned int index);
+	void UnselectUnit(Device &device, unsigned int index, long serviceTime);
+
+	// I/O completion
+	static void* QueueWorker(void* threadarg);
+	static void* DeviceWorker(void* threadarg);
+	void WaitUntil(long double deviceTime);
+	void EndIOThread();
+	long double Now();
+	void ScheduleIOEvent(long double time, unsigned int device, unsigned int index, DeviceQueue::Request request);
+	void ScheduleBatch(unsigned int device, unsigned int index, long double startTime);
+	void RecordBatchWaits(unsigned int device, const DeviceQueue::Batch &batch, long double startTime);
+	void CompleteIO(DeviceQueue::Request &request);
+	void UnlockBlock(int processID, unsigned long block);
+	void WakeMemoryWaiters();
+
 	// Resource quantities
-	unsigned int projectors;
-	unsigned int hardDrives;
-	unsigned long memory;
-	unsigned long blockSize;
+	unsigned long memoryBlocks;
+	unsigned long blockSize;					// Memory block size, in kbytes; memory addresses count kbytes
 
 	// Resource counts
-	unsigned int projectorCount;
-	unsigned int hardDriveCount;
-	unsigned long memoryCount;
+	std::atomic<unsigned long> memoryCount;
+
+	// Memory allocation status
+	DeadlockDetector deadlocks;
+	pthread_mutex_t memoryMutex;				// Guards the memory allocation status; every memory block is granted and released under it
+	std::vector<int> memoryWaiters;				// Processes to wake when memory is released
+	std::map<int, long double> memoryRequested;	// Time (us) at which each waiting process first requested its block
+	std::vector<int> blockOwners;				// Process holding each memory block, or -1 if free
+
+	// Virtual memory status
+	bool paging;								// true if memory is paged; memory blocks are then frames
+	PagingUnit pagingUnit;
+
+	// Device unit status
+	SelectionPolicy selectionPolicy;
+	std::vector<Device> devices;				// Every device class, in the order of the configuration's registry
+	Timer deviceClock;
+
+	// Asynchronous I/O status, shared with I/O threads
+	pthread_mutex_t deviceMutex;				// Guards device unit status and request queues
+	pthread_mutex_t completionMutex;			// Guards completedIO, pendingIO and wakeCount
+	pthread_cond_t completionReady;
+	std::vector<int> completedIO;				// Processes whose I/O has completed since the last TakeCompletions
+	unsigned int pendingIO;
+	unsigned long wakeCount;					// Completions and wake-ups posted, for threads idling in WaitForWake
+	std::atomic<unsigned int> ioThreads;		// I/O threads which have not ended; they end under completionMutex
+	pthread_cond_t ioThreadsEnded;
+
+	// Virtual time I/O status
+	const long double* virtualClock;			// Simulated time (us), or NULL when devices run in real time
+	std::priority_queue<IOEvent> ioEvents;
+	unsigned long ioEventCount;
 };
 
 #endif	// !RESOURCEMANAGER_H
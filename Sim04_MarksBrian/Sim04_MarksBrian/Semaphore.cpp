@@ -0,0 +1,209 @@
+/**
+*	@file Semaphore.cpp
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class implementation for a counting semaphore with FIFO fairness and futex parking.
+*	@date Friday, April 27, 2018
+*/
+
+//
+// Header Files ///////////////////////////
+//
+#include "Semaphore.h"
+#include "Profiler.h"
+
+//
+// Class Function Definitions /////////////////
+//
+
+/**	Constructor
+*	\n Creates a semaphore.
+*	@param permits is the number of threads which may hold the semaphore at once
+*	@param histogram receives the wait time of every acquisition; NULL to not record waits
+*/
+Semaphore::Semaphore(unsigned long permits, WaitHistogram* histogram) : permits(permits), spinLimit(MIN_SPINS), waits(histogram) {
+	pthread_mutex_init(&queueMutex, NULL);
+}
+
+/**	Destructor
+*	\n Releases the queue mutex. No thread may be waiting.
+*/
+Semaphore::~Semaphore() {
+	pthread_mutex_destroy(&queueMutex);
+}
+
+/**	Wait
+*	\n Takes a permit, blocking until one is available.
+*/
+void Semaphore::Wait() {
+	Acquire(-1);
+}
+
+/**	Timed Wait
+*	\n Takes a permit, blocking for at most the given time.
+*	@param microSeconds is the longest time to wait
+*	@return true if a permit was taken, false if the wait timed out
+*/
+bool Semaphore::TimedWait(long double microSeconds) {
+	return Acquire(microSeconds < 0 ? 0 : microSeconds);
+}
+
+/**	Try Wait
+*	\n Takes a permit only if one is free. Never overtakes a queued thread, since no permit is free while one is queued.
+*	@return true if a permit was taken
+*/
+bool Semaphore::TryWait() {
+	long free = permits.load(std::memory_order_relaxed);
+	while (free > 0) {
+		if (permits.compare_exchange_weak(free, free - 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**	Post
+*	\n Returns a permit. The permit is handed directly to the oldest queued thread, if there is one.
+*/
+void Semaphore::Post() {
+	pthread_mutex_lock(&queueMutex);
+	if (waiters.empty()) {
+		permits.fetch_add(1, std::memory_order_release);
+		pthread_mutex_unlock(&queueMutex);
+		return;
+	}
+
+	Waiter* next = waiters.front();
+	waiters.pop_front();
+	next->granted.store(1, std::memory_order_release);
+#ifdef __linux__
+	syscall(SYS_futex, (int*)&next->granted, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#endif
+	pthread_mutex_unlock(&queueMutex);
+}
+
+/**	Get Permits
+*	\n Getter function for the number of free permits. The answer may be stale as soon as it is returned.
+*	@return the number of free permits
+*/
+unsigned long Semaphore::GetPermits() const {
+	return permits.load(std::memory_order_relaxed);
+}
+
+/**	Acquire
+*	\n Takes a permit: spins briefly, then queues and parks. Records the time waited.
+*	@param microSeconds is the longest time to wait, or negative to wait forever
+*	@return true if a permit was taken, false if the wait timed out
+*/
+bool Semaphore::Acquire(long double microSeconds) {
+	if (TryWait()) {
+		if (waits != NULL) {
+			waits->Record(0);
+		}
+		return true;
+	}
+
+	// Only contended acquisitions are profiled, so the uncontended path stays a single atomic operation
+	PROFILE_ZONE("lock wait");
+	long double began = Clock();
+	bool acquired = Spin();
+
+	if (!acquired) {
+		Waiter waiter;
+
+		pthread_mutex_lock(&queueMutex);
+		if (TryWait()) {
+			acquired = true;
+		}
+		else {
+			waiters.push_back(&waiter);
+		}
+		pthread_mutex_unlock(&queueMutex);
+
+		if (!acquired) {
+			acquired = Park(waiter, microSeconds);
+		}
+	}
+
+	if (acquired && waits != NULL) {
+		waits->Record(Clock() - began);
+	}
+	return acquired;
+}
+
+/**	Spin
+*	\n Retries for a permit a bounded number of times before the caller parks. The bound doubles when spinning
+*	succeeds and halves when it fails, so short critical sections are waited out while long ones are slept through.
+*	@return true if a permit was taken
+*/
+bool Semaphore::Spin() {
+	int limit = spinLimit.load(std::memory_order_relaxed);
+
+	for (int i = 0; i < limit; i++) {
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#endif
+		if (TryWait()) {
+			spinLimit.store(limit * 2 > MAX_SPINS ? MAX_SPINS : limit * 2, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	spinLimit.store(limit / 2 < MIN_SPINS ? MIN_SPINS : limit / 2, std::memory_order_relaxed);
+	return false;
+}
+
+/**	Park
+*	\n Sleeps a queued thread until a permit is handed to it. A thread which times out leaves the queue, unless a
+*	permit was handed to it first, in which case it keeps the permit.
+*	@param waiter is the caller's entry in the queue
+*	@param microSeconds is the longest time to wait, or negative to wait forever
+*	@return true if a permit was handed over, false if the wait timed out
+*/
+bool Semaphore::Park(Waiter &waiter, long double microSeconds) {
+	long double deadline = Clock() + microSeconds;
+
+	while (waiter.granted.load(std::memory_order_acquire) == 0) {
+		long double remaining = deadline - Clock();
+		if (microSeconds >= 0 && remaining <= 0) {
+			break;
+		}
+#ifdef __linux__
+		struct timespec timeout;
+		timeout.tv_sec = (time_t)(remaining / 1000000);
+		timeout.tv_nsec = (long)((remaining - (long double)timeout.tv_sec * 1000000) * 1000);
+		syscall(SYS_futex, (int*)&waiter.granted, FUTEX_WAIT_PRIVATE, 0, (microSeconds >= 0 ? &timeout : NULL), NULL, 0);
+#else
+		usleep(50);
+#endif
+	}
+
+	if (waiter.granted.load(std::memory_order_acquire) == 1) {
+		return true;
+	}
+
+	// Timed out: leave the queue unless a permit arrived meanwhile
+	pthread_mutex_lock(&queueMutex);
+	bool granted = (waiter.granted.load(std::memory_order_acquire) == 1);
+	if (!granted) {
+		for (std::deque<Waiter*>::iterator it = waiters.begin(); it != waiters.end(); ++it) {
+			if (*it == &waiter) {
+				waiters.erase(it);
+				break;
+			}
+		}
+	}
+	pthread_mutex_unlock(&queueMutex);
+
+	return granted;
+}
+
+/**	Clock
+*	\n Reads a monotonic clock.
+*	@return the current time in microseconds
+*/
+long double Semaphore::Clock() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (long double)now.tv_sec * 1000000 + (long double)now.tv_nsec / 1000;
+}
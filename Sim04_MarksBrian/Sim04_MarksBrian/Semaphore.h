@@ -0,0 +1,77 @@
+/**
+*	@file Semaphore.h
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class declaration for a counting semaphore with FIFO fairness. A waiter first spins for a bounded,
+*	adaptive number of attempts, then queues and parks its thread (on a futex under Linux) until a permit is handed
+*	to it directly, so a thread arriving later can never overtake a queued one.
+*	@date Friday, April 27, 2018
+*/
+
+//
+// Compiler Guards ////////////////////////
+//
+#ifndef SEMAPHORE_H
+#define SEMAPHORE_H
+
+//
+// Header Files ///////////////////////////
+//
+#include <atomic>
+#include <deque>
+#include <ctime>
+#include <pthread.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#include "WaitHistogram.h"
+
+//
+// Class Declaration ///////////////////////////
+//
+class Semaphore {
+public:
+	// Constructor/Destructor
+	Semaphore(unsigned long permits = 1, WaitHistogram* histogram = NULL);
+	~Semaphore();
+
+	// Semaphore functions
+	void Wait();
+	bool TimedWait(long double microSeconds);
+	bool TryWait();
+	void Post();
+
+	// Accessors
+	unsigned long GetPermits() const;
+
+private:
+	// A parked thread, living on the waiter's stack
+	struct Waiter {
+		Waiter() : granted(0) {};
+
+		std::atomic<int> granted;		// Set to 1 when a permit is handed over; the futex word
+	};
+
+	static const int MIN_SPINS = 16;
+	static const int MAX_SPINS = 1024;
+
+	// Not copyable
+	Semaphore(const Semaphore&);
+	Semaphore& operator=(const Semaphore&);
+
+	// Private functions
+	bool Acquire(long double microSeconds);
+	bool Spin();
+	bool Park(Waiter &waiter, long double microSeconds);
+	static long double Clock();
+
+	std::atomic<long> permits;			// Free permits; 0 whenever a thread is queued
+	std::atomic<int> spinLimit;			// Attempts before parking, adapted to how often spinning succeeds
+	pthread_mutex_t queueMutex;			// Guards waiters, and permits when a thread may be queued
+	std::deque<Waiter*> waiters;		// Parked threads, oldest first
+	WaitHistogram* waits;				// Receives the time every acquisition waited, if not NULL
+};
+
+#endif	// !SEMAPHORE_H
@@ -13,14 +13,21 @@
 
 #include <iostream>
 #include <unistd.h>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include "Batch.h"
 #include "Config.h"
 #include "Log.h"
 #include "OperatingSystem.h"
 #include "Lock.h"
+#include "Profiler.h"
+#include "Trace.h"
 
 // Global declaration of shared classes
 Config conf;
 Log logger;
+Trace trace;
 Lock lock;
 
 //
@@ -28,12 +35,71 @@ Lock lock;
 //
 int main(int argc, char* argv[]) {
 
-	if (argc != 2) {
+	// Batch options: run the configuration many times over (-b), and vary it (-v) or override its lines (-o)
+	unsigned int runs = 0;
+	unsigned int jobs = 0;
+	bool seedGiven = false;
+	uint64_t seed = 0;
+	std::vector<std::string> overrides;
+	std::vector<std::string> variations;
+	int option;
+
+	while ((option = getopt(argc, argv, "b:j:s:o:v:")) != -1) {
+		switch (option) {
+			case 'b':
+				runs = atoi(optarg) > 0 ? atoi(optarg) : 1;
+				break;
+			case 'j':
+				jobs = atoi(optarg) > 0 ? atoi(optarg) : 1;
+				break;
+			case 's':
+				seed = strtoull(optarg, NULL, 10);
+				seedGiven = true;
+				break;
+			case 'o':
+				overrides.push_back(optarg);
+				break;
+			case 'v':
+				variations.push_back(optarg);
+				break;
+			default:
+				std::cerr << "Usage: Sim04 config [-o \"Key: value\"]... [-s seed] [-b runs [-j jobs] [-v \"Key: value|value|...\"]...]" << std::endl;
+				return 2;
+		}
+	}
+
+	if (optind != argc - 1) {
 		std::cout << "Error: Can only run exactly one file name passed as a command line parameter." << std::endl;		// Throw error if there is not exactly one argument in command line
 		exit(0);
 	}
+	if (runs == 0 && (jobs > 0 || !variations.empty())) {
+		std::cout << "Error: Jobs and variations apply only to batch runs, given with -b." << std::endl;
+		exit(0);
+	}
 
-	conf.ConfigInit(argv[1]);		// Initialize config information
+	// Batch: summarize many virtual-time runs instead of logging one
+	if (runs > 0) {
+		Batch batch(argv[optind], runs);
+		if (jobs > 0) {
+			batch.SetJobs(jobs);
+		}
+		if (seedGiven) {
+			batch.SetFirstSeed(seed);
+		}
+		for (unsigned int i = 0; i < overrides.size(); i++) {
+			batch.AddOverride(overrides[i]);
+		}
+		for (unsigned int i = 0; i < variations.size(); i++) {
+			batch.AddVariation(variations[i]);
+		}
+		batch.Run();
+		return 0;
+	}
+
+	conf.ConfigInit(argv[optind], overrides);		// Initialize config information
+	if (seedGiven) {
+		conf.randomSeed = seed;
+	}
 
 	OperatingSystem os;				// Initialize the operating system
 
@@ -41,5 +107,15 @@ int main(int argc, char* argv[]) {
 
 	logger.streamToFile();			// Log the results
 
+#ifdef SIM_PROFILE
+	// Write the profile beside the log: <log path without extension>.trace.json
+	std::string tracePath = conf.logPath;
+	std::string::size_type extension = tracePath.find_last_of('.');
+	if (extension != std::string::npos && (tracePath.find_last_of('/') == std::string::npos || extension > tracePath.find_last_of('/'))) {
+		tracePath.erase(extension);
+	}
+	Profiler::Export(tracePath + ".trace.json");
+#endif
+
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,89 @@
+/**
+*	@file SimLog.cpp
+*	@author Brian Marks
+*	@version 1.0
+*	@details Command line tool which renders a binary event log ("Log: Log to Binary") as the text log the simulator
+*	would have written, or as the log of one of its CPUs.
+*	@date Monday, April 30, 2018
+*/
+
+//
+// Header Files ///////////////////////
+//
+
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <unistd.h>
+#include "EventLog.h"
+
+//
+// Usage
+//
+static void usage() {
+	std::cerr << "Usage: simlog [options] log\n"
+		<< "  -c cpu      render only the events logged from this CPU, as its per-CPU log\n"
+		<< "  -o file     output file (default standard output)" << std::endl;
+	exit(1);
+}
+
+//
+// Main Function Implementation
+//
+int main(int argc, char* argv[]) {
+	EventLog events;
+	int cpu = -1;
+	const char* outputName = NULL;
+	int option;
+
+	try {
+		while ((option = getopt(argc, argv, "c:o:")) != -1) {
+			switch (option) {
+				case 'c':
+					cpu = atoi(optarg);
+					if (cpu < 0) {
+						usage();
+					}
+					break;
+				case 'o':
+					outputName = optarg;
+					break;
+				default:
+					usage();
+			}
+		}
+		if (optind != argc - 1) {
+			usage();
+		}
+		events.Load(argv[optind]);
+
+		std::ofstream fout;
+		if (outputName) {
+			fout.open(outputName, std::ofstream::out);
+			if (!fout.good()) {
+				throw std::logic_error("Output file could not be opened.");
+			}
+		}
+		std::ostream &out = outputName ? fout : std::cout;
+
+		EventLog::Record record;
+		std::string line;
+		while (events.Next(record)) {
+			if (cpu >= 0 && record.cpu != cpu) {
+				continue;
+			}
+			EventLog::Render(record, line);
+			out << line << '\n';
+		}
+		out.flush();
+		if (!out.good()) {
+			throw std::logic_error("Log could not be written.");
+		}
+	}
+	catch (std::logic_error &e) {
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,550 @@
+/**
+*	@file Trace.cpp
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class implementation for deterministic record and replay of real-time simulations.
+*	@date Monday, April 30, 2018
+*/
+
+//
+// Header Files ///////////////////////////
+//
+#include "Trace.h"
+#include "Varint.h"
+#include <cerrno>
+#include <fstream>
+#include <iterator>
+
+//
+// Class Function Definitions /////////////////
+//
+
+// Threads not named otherwise are the main thread
+thread_local uint32_t Trace::thread = 0;
+
+/**	Constructor
+*	\n Creates a trace which neither records nor replays.
+*/
+Trace::Trace() : diverged(false), progress(0) {
+	mode = OFF;
+	cpuCount = 0;
+	bytes = 0;
+	pthread_mutex_init(&turnMutex, NULL);
+	pthread_cond_init(&turnTaken, NULL);
+}
+
+/**	Destructor
+*	\n Releases the turn mutex and condition.
+*/
+Trace::~Trace() {
+	pthread_cond_destroy(&turnTaken);
+	pthread_mutex_destroy(&turnMutex);
+}
+
+/**	Start
+*	\n Starts recording or replaying, before the threads being traced are created.
+*	@param code is OFF, RECORD or REPLAY
+*	@param path is the trace file written when recording, or read when replaying
+*	@param channels is the number of traced locks
+*	@param cpus is the number of simulated CPUs
+*	@throw the code is invalid, no file is given, or the file cannot be read or was recorded on another machine
+*/
+void Trace::Start(std::string code, std::string path, unsigned int channels, unsigned int cpus) throw(std::logic_error) {
+	mode = OFF;
+	tracePath = path;
+	cpuCount = cpus;
+	streams.assign(channels, Stream());
+	decisions.assign(cpus, std::vector<Decision>());
+	nextDecision.assign(cpus, 0);
+	bytes = 0;
+	summary.clear();
+	diverged = false;
+	divergence.clear();
+	progress = (long)Now();
+
+	if (code == "OFF") {
+		return;
+	}
+	if (code != "RECORD" && code != "REPLAY") {
+		throw std::logic_error("Trace code must be OFF, RECORD or REPLAY; check configuration file.");
+	}
+	if (path.empty()) {
+		throw std::logic_error("Trace File Path is required to record or replay; check configuration file.");
+	}
+
+	if (code == "REPLAY") {
+		Read();
+		mode = REPLAY;
+	}
+	else {
+		mode = RECORD;
+	}
+}
+
+/**	Finish
+*	\n Stops recording or replaying, after the threads being traced have ended. A recording is written to the trace
+*	file; a replay is checked to have made every acquisition and dispatch of the trace, and no other.
+*	@throw the trace file cannot be written, or the replay diverged from the trace
+*/
+void Trace::Finish() throw(std::logic_error) {
+	Mode finished = mode;
+	mode = OFF;
+
+	pthread_mutex_lock(&turnMutex);
+	unsigned long acquisitions = 0;
+	for (unsigned int c = 0; c < streams.size(); c++) {
+		for (unsigned int i = 0; i < streams[c].runs.size(); i++) {
+			acquisitions += streams[c].runs[i].count;
+		}
+		if (finished == REPLAY && !diverged && streams[c].next < streams[c].runs.size()) {
+			Diverge("acquisition " + std::to_string(streams[c].acquired + 1) + " of the " + ChannelName(c) + ", which was never made");
+		}
+	}
+	unsigned long dispatches = 0;
+	for (unsigned int cpu = 0; cpu < decisions.size(); cpu++) {
+		dispatches += decisions[cpu].size();
+		if (finished == REPLAY && !diverged && nextDecision[cpu] < decisions[cpu].size()) {
+			Diverge("dispatch " + std::to_string(nextDecision[cpu] + 1) + " of CPU " + std::to_string(cpu) + ", which was never made");
+		}
+	}
+	pthread_mutex_unlock(&turnMutex);
+	std::string counts = std::to_string(acquisitions) + " lock acquisitions and " + std::to_string(dispatches) + " dispatches";
+
+	if (finished == RECORD) {
+		Write();
+		summary = "trace of " + counts + " recorded to " + tracePath + " (" + std::to_string(bytes) + " bytes)";
+	}
+	else if (finished == REPLAY) {
+		if (diverged) {
+			throw std::logic_error("Replay diverged from the trace at " + divergence + ".");
+		}
+		summary = "replay followed the trace of " + counts + " from " + tracePath;
+	}
+}
+
+/**	Recording
+*	\n Getter function for whether the trace is being recorded.
+*	@return true if recording
+*/
+bool Trace::Recording() const {
+	return mode == RECORD;
+}
+
+/**	Replaying
+*	\n Getter function for whether the trace is being replayed.
+*	@return true if replaying
+*/
+bool Trace::Replaying() const {
+	return mode == REPLAY;
+}
+
+/**	Diverged
+*	\n Getter function for whether the replay has left the trace. The threads then run unordered.
+*	@return true if the replay has diverged
+*/
+bool Trace::Diverged() const {
+	return diverged;
+}
+
+/**	Get Divergence
+*	\n Getter function for where the replay left the trace.
+*	@return the acquisition or dispatch the replay could not make, or "" if it has not diverged
+*/
+std::string Trace::GetDivergence() const {
+	return diverged ? "Replay diverged from the trace at " + divergence + "." : "";
+}
+
+/**	Summary
+*	\n Getter function for a description of the finished recording or replay, for the log.
+*	@pre Finish() must have completed.
+*	@return what was recorded or replayed, or "" if neither
+*/
+std::string Trace::Summary() const {
+	return summary;
+}
+
+/**	Set Thread
+*	\n Names the calling thread, before it acquires a traced lock.
+*	@param name is the thread's name, from CPUThread, RequestThread or UnitThread
+*/
+void Trace::SetThread(uint32_t name) {
+	thread = name;
+}
+
+/**	CPU Thread
+*	\n Names the thread simulating a CPU.
+*	@param cpu is the CPU
+*	@return the thread's name
+*/
+uint32_t Trace::CPUThread(unsigned int cpu) {
+	return (cpu << 2) | 1;
+}
+
+/**	Request Thread
+*	\n Names the thread servicing the I/O request of a process; a process has one request at a time.
+*	@param processID is the process
+*	@return the thread's name
+*/
+uint32_t Trace::RequestThread(int processID) {
+	return ((uint32_t)processID << 2) | 2;
+}
+
+/**	Unit Thread
+*	\n Names the thread servicing the request queue of a unit of a device; a unit has one such thread at a time.
+*	@param device is the device class
+*	@param unit is the unit
+*	@return the thread's name
+*/
+uint32_t Trace::UnitThread(unsigned int device, unsigned int unit) {
+	return (((device << 16) | unit) << 2) | 3;
+}
+
+/**	Acquire Mutex
+*	\n Locks a traced mutex. Recording appends the calling thread to the lock's order once the mutex is held;
+*	replaying first waits until the calling thread is next in the lock's order.
+*	@param mutex is the mutex to lock
+*	@param channel is the traced lock the mutex is
+*/
+void Trace::Acquire(pthread_mutex_t* mutex, unsigned int channel) {
+	Mode current = mode;
+	if (current == OFF || channel >= streams.size()) {
+		pthread_mutex_lock(mutex);
+		return;
+	}
+
+	if (current == REPLAY) {
+		AwaitTurn(channel);
+	}
+	pthread_mutex_lock(mutex);
+	if (current == RECORD) {
+		Append(channel);
+	}
+	else {
+		TakeTurn(channel);
+	}
+}
+
+/**	Acquire Semaphore
+*	\n Waits on a traced semaphore of one permit, as Acquire does for a mutex.
+*	@param semaphore is the semaphore to wait on
+*	@param channel is the traced lock the semaphore is
+*/
+void Trace::Acquire(Semaphore &semaphore, unsigned int channel) {
+	Mode current = mode;
+	if (current == OFF || channel >= streams.size()) {
+		semaphore.Wait();
+		return;
+	}
+
+	if (current == REPLAY) {
+		AwaitTurn(channel);
+	}
+	semaphore.Wait();
+	if (current == RECORD) {
+		Append(channel);
+	}
+	else {
+		TakeTurn(channel);
+	}
+}
+
+/**	Choose
+*	\n Records a choice made while holding a traced lock, or when replaying, gives back the choice made at that point.
+*	@pre The lock must be held, which guards its choices.
+*	@param channel is the traced lock
+*	@param choice is the choice the calling thread made
+*	@return the choice to act on
+*/
+unsigned int Trace::Choose(unsigned int channel, unsigned int choice) {
+	Mode current = mode;
+	if (current == OFF || channel >= streams.size()) {
+		return choice;
+	}
+
+	Stream &stream = streams[channel];
+	if (current == RECORD) {
+		stream.choices.push_back(choice);
+	}
+	else if (stream.nextChoice < stream.choices.size()) {
+		choice = stream.choices[stream.nextChoice++];
+	}
+	else {
+		pthread_mutex_lock(&turnMutex);
+		Diverge("choice " + std::to_string(stream.nextChoice + 1) + " under the " + ChannelName(channel) + ", beyond the end of the trace");
+		pthread_mutex_unlock(&turnMutex);
+	}
+	return choice;
+}
+
+/**	Decide
+*	\n Records that a core is running a process, when recording. Only the core's own thread may call it.
+*	@param cpu is the core
+*	@param process is the process being run
+*	@param dispatch is the number of times the process was run before
+*/
+void Trace::Decide(unsigned int cpu, unsigned int process, unsigned int dispatch) {
+	if (mode == RECORD && cpu < decisions.size()) {
+		decisions[cpu].push_back(Decision(process, dispatch));
+	}
+}
+
+/**	Next Decision
+*	\n Getter function for the next process a core ran, when replaying. Only the core's own thread may call it.
+*	@param cpu is the core
+*	@param process receives the process the core ran
+*	@param dispatch receives the number of times the process was run before
+*	@return true if the core ran another process
+*/
+bool Trace::NextDecision(unsigned int cpu, unsigned int &process, unsigned int &dispatch) const {
+	if (cpu >= decisions.size() || nextDecision[cpu] >= decisions[cpu].size()) {
+		return false;
+	}
+	process = decisions[cpu][nextDecision[cpu]].process;
+	dispatch = decisions[cpu][nextDecision[cpu]].dispatch;
+	return true;
+}
+
+/**	Take Decision
+*	\n Moves a core on to its following decision, once it runs the process NextDecision gave.
+*	@param cpu is the core
+*/
+void Trace::TakeDecision(unsigned int cpu) {
+	nextDecision[cpu]++;
+	progress = (long)Now();
+}
+
+/**	Check Stall
+*	\n Checks whether a replay has stopped following the trace: it has diverged at a lock, or no thread has taken a
+*	turn nor any core dispatched for stallLimit seconds while the core still has processes to run.
+*	@param cpu is the core waiting for its next process
+*	@return true if the replay has diverged
+*/
+bool Trace::CheckStall(unsigned int cpu) {
+	if (mode != REPLAY) {
+		return false;
+	}
+	if (!diverged && cpu < decisions.size() && nextDecision[cpu] < decisions[cpu].size() && (long)Now() - progress > stallLimit) {
+		pthread_mutex_lock(&turnMutex);
+		Diverge("dispatch " + std::to_string(nextDecision[cpu] + 1) + " of CPU " + std::to_string(cpu) + ", whose process "
+			+ std::to_string(decisions[cpu][nextDecision[cpu]].process + 1) + " never became ready");
+		pthread_mutex_unlock(&turnMutex);
+	}
+	return diverged;
+}
+
+/**	Append
+*	\n Appends the calling thread to a lock's order.
+*	@pre The lock must be held, which guards its order.
+*	@param channel is the traced lock
+*/
+void Trace::Append(unsigned int channel) {
+	std::vector<Run> &runs = streams[channel].runs;
+	if (!runs.empty() && runs.back().thread == thread) {
+		runs.back().count++;
+	}
+	else {
+		runs.push_back(Run(thread, 1));
+	}
+}
+
+/**	Await Turn
+*	\n Waits until the calling thread is next in a lock's order. A thread which is not in the order at all, or which
+*	waits for stallLimit seconds without any thread taking a turn, makes the replay diverge; the threads then run
+*	unordered, so the run can end and report it.
+*	@param channel is the traced lock
+*/
+void Trace::AwaitTurn(unsigned int channel) {
+	pthread_mutex_lock(&turnMutex);
+	bool timedOut = false;
+	while (!diverged) {
+		Stream &stream = streams[channel];
+		std::string where = "acquisition " + std::to_string(stream.acquired + 1) + " of the " + ChannelName(channel);
+		if (stream.next >= stream.runs.size()) {
+			Diverge(where + ", beyond the end of the trace");
+			break;
+		}
+		if (stream.runs[stream.next].thread == thread) {
+			break;
+		}
+		if (timedOut) {
+			Diverge(where + ", made by another thread");
+			break;
+		}
+
+		struct timespec deadline;
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += stallLimit;
+		timedOut = (pthread_cond_timedwait(&turnTaken, &turnMutex, &deadline) == ETIMEDOUT);
+	}
+	pthread_mutex_unlock(&turnMutex);
+}
+
+/**	Take Turn
+*	\n Moves a lock's order on past the calling thread's acquisition, waking the threads waiting for their turn when
+*	the next acquisition is another thread's.
+*	@param channel is the traced lock
+*/
+void Trace::TakeTurn(unsigned int channel) {
+	pthread_mutex_lock(&turnMutex);
+	Stream &stream = streams[channel];
+	if (!diverged && stream.next < stream.runs.size()) {
+		stream.acquired++;
+		if (++stream.used >= stream.runs[stream.next].count) {
+			stream.next++;
+			stream.used = 0;
+			progress = (long)Now();
+			pthread_cond_broadcast(&turnTaken);
+		}
+	}
+	pthread_mutex_unlock(&turnMutex);
+}
+
+/**	Diverge
+*	\n Records where the replay left the trace, and releases every thread waiting for its turn.
+*	@pre turnMutex must be held.
+*	@param where is the acquisition or dispatch the replay could not make
+*/
+void Trace::Diverge(std::string where) {
+	if (!diverged) {
+		divergence = where;
+		diverged = true;
+	}
+	pthread_cond_broadcast(&turnTaken);
+}
+
+/**	Channel Name
+*	\n Names a traced lock, for reporting a divergence.
+*	@param channel is the traced lock
+*	@return the lock's name
+*/
+std::string Trace::ChannelName(unsigned int channel) const {
+	switch (channel) {
+		case LOG:
+			return "log";
+		case MUTEX:
+			return "global mutex";
+		case DEVICES:
+			return "device status";
+		case MEMORY:
+			return "memory status";
+		case PAGING:
+			return "page tables";
+		default:
+			return "device unit lock " + std::to_string(channel - CHANNEL_COUNT);
+	}
+}
+
+/**	Write
+*	\n Writes the recording to the trace file: "SIMTRACE", the format version, then each lock's order as runs of
+*	(thread, count) followed by its choices, then each core's decisions as (process, dispatch), every number a variable-length integer.
+*	@throw the file cannot be written
+*/
+void Trace::Write() throw(std::logic_error) {
+	std::string out = "SIMTRACE";
+	Varint::Write(out, 1);
+
+	Varint::Write(out, streams.size());
+	for (unsigned int c = 0; c < streams.size(); c++) {
+		Varint::Write(out, streams[c].runs.size());
+		for (unsigned int i = 0; i < streams[c].runs.size(); i++) {
+			Varint::Write(out, streams[c].runs[i].thread);
+			Varint::Write(out, streams[c].runs[i].count);
+		}
+		Varint::Write(out, streams[c].choices.size());
+		for (unsigned int i = 0; i < streams[c].choices.size(); i++) {
+			Varint::Write(out, streams[c].choices[i]);
+		}
+	}
+	Varint::Write(out, decisions.size());
+	for (unsigned int cpu = 0; cpu < decisions.size(); cpu++) {
+		Varint::Write(out, decisions[cpu].size());
+		for (unsigned int i = 0; i < decisions[cpu].size(); i++) {
+			Varint::Write(out, decisions[cpu][i].process);
+			Varint::Write(out, decisions[cpu][i].dispatch);
+		}
+	}
+
+	std::ofstream fout(tracePath.c_str(), std::ios::binary | std::ios::trunc);
+	fout.write(out.data(), out.size());
+	if (!fout.good()) {
+		throw std::logic_error("Trace file cannot be written; check configuration file.");
+	}
+	bytes = out.size();
+}
+
+/**	Read
+*	\n Reads a recording from the trace file, to replay it.
+*	@throw the file cannot be read, is not a trace, or was recorded with other devices or another number of CPUs
+*/
+void Trace::Read() throw(std::logic_error) {
+	std::ifstream fin(tracePath.c_str(), std::ios::binary);
+	if (!fin.good()) {
+		throw std::logic_error("Trace file cannot be read; check configuration file.");
+	}
+	std::string in((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+	bytes = in.size();
+
+	size_t pos = 8;
+	if (in.compare(0, 8, "SIMTRACE") != 0 || ReadNumber(in, pos) != 1) {
+		throw std::logic_error("Trace file is not a trace, or is damaged; check configuration file.");
+	}
+
+	if (ReadNumber(in, pos) != streams.size()) {
+		throw std::logic_error("Trace was recorded with other devices; check configuration file.");
+	}
+	for (unsigned int c = 0; c < streams.size(); c++) {
+		uint64_t runs = ReadNumber(in, pos);
+		for (uint64_t i = 0; i < runs; i++) {
+			uint32_t name = (uint32_t)ReadNumber(in, pos);
+			unsigned long count = ReadNumber(in, pos);
+			if (count == 0) {
+				throw std::logic_error("Trace file is not a trace, or is damaged; check configuration file.");
+			}
+			streams[c].runs.push_back(Run(name, count));
+		}
+		uint64_t choices = ReadNumber(in, pos);
+		for (uint64_t i = 0; i < choices; i++) {
+			streams[c].choices.push_back((unsigned int)ReadNumber(in, pos));
+		}
+	}
+
+	if (ReadNumber(in, pos) != cpuCount) {
+		throw std::logic_error("Trace was recorded with another processor quantity; check configuration file.");
+	}
+	for (unsigned int cpu = 0; cpu < cpuCount; cpu++) {
+		uint64_t count = ReadNumber(in, pos);
+		for (uint64_t i = 0; i < count; i++) {
+			unsigned int process = ReadNumber(in, pos);
+			unsigned int dispatch = ReadNumber(in, pos);
+			decisions[cpu].push_back(Decision(process, dispatch));
+		}
+	}
+	if (pos != in.size()) {
+		throw std::logic_error("Trace file is not a trace, or is damaged; check configuration file.");
+	}
+}
+
+/**	Read Number
+*	\n Reads a variable-length integer written by Varint::Write.
+*	@param in is the text being read
+*	@param pos is the position of the number, moved past it
+*	@return the number
+*	@throw the text ends within the number, or the number has more than 64 bits
+*/
+uint64_t Trace::ReadNumber(const std::string &in, size_t &pos) throw(std::logic_error) {
+	uint64_t value;
+	if (!Varint::Read(in, pos, value)) {
+		throw std::logic_error("Trace file is not a trace, or is damaged; check configuration file.");
+	}
+	return value;
+}
+
+/**	Now
+*	\n Reads the monotonic clock.
+*	@return seconds since an arbitrary fixed point
+*/
+long double Trace::Now() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9L;
+}
@@ -0,0 +1,147 @@
+/**
+*	@file Trace.h
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class declaration for deterministic record and replay of real-time simulations. Recording keeps, for each
+*	traced lock, the order in which the threads acquired it, and for each core the processes it dispatched; the order
+*	is appended while the lock is still held, so recording takes no lock of its own. Replaying makes every thread wait
+*	for its turn at each traced lock and every core run the processes it ran before, which reproduces the interleaving
+*	of the log and of the device and memory status. Choices a thread makes by the clock while holding a traced lock,
+*	such as the unit a device request goes to, are recorded with the lock and given back in replay. Threads are named by what they simulate (a CPU, the I/O of a
+*	process, a unit of a device), so a name means the same thread in every run. The trace is written in runs of
+*	acquisitions by one thread, as variable-length integers.
+*	@date Monday, April 30, 2018
+*/
+
+//
+// Compiler Guards ////////////////////////
+//
+#ifndef TRACE_H
+#define TRACE_H
+
+//
+// Header Files ///////////////////////////
+//
+#include <atomic>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+#include "Semaphore.h"
+
+//
+// Class Declaration ///////////////////////////
+//
+class Trace {
+public:
+	// Traced locks; each unit of each device follows, numbered by Lock
+	enum Channel {
+		LOG,				// Log lines
+		MUTEX,				// The global mutex
+		DEVICES,			// Device unit status and request queues
+		MEMORY,				// Memory allocation status
+		PAGING,				// Frames and page tables
+		CHANNEL_COUNT
+	};
+
+	// Constructor/Destructor
+	Trace();
+	~Trace();
+
+	// Control functions
+	void Start(std::string code, std::string path, unsigned int channels, unsigned int cpus) throw(std::logic_error);
+	void Finish() throw(std::logic_error);
+	bool Recording() const;
+	bool Replaying() const;
+	bool Diverged() const;
+	std::string GetDivergence() const;
+	std::string Summary() const;
+
+	// Thread names
+	static void SetThread(uint32_t name);
+	static uint32_t CPUThread(unsigned int cpu);
+	static uint32_t RequestThread(int processID);
+	static uint32_t UnitThread(unsigned int device, unsigned int unit);
+
+	// Lock functions
+	void Acquire(pthread_mutex_t* mutex, unsigned int channel);
+	void Acquire(Semaphore &semaphore, unsigned int channel);
+	unsigned int Choose(unsigned int channel, unsigned int choice);
+
+	// Scheduling decision functions
+	void Decide(unsigned int cpu, unsigned int process, unsigned int dispatch);
+	bool NextDecision(unsigned int cpu, unsigned int &process, unsigned int &dispatch) const;
+	void TakeDecision(unsigned int cpu);
+	bool CheckStall(unsigned int cpu);
+
+private:
+	enum Mode { OFF, RECORD, REPLAY };
+
+	// Consecutive acquisitions of a lock by one thread
+	struct Run {
+		Run(uint32_t runThread, unsigned long runCount) : thread(runThread), count(runCount) {};
+
+		uint32_t thread;
+		unsigned long count;
+	};
+
+	// The acquisitions of a lock and the choices made under it, and while replaying, how many have been made
+	struct Stream {
+		Stream() : next(0), used(0), acquired(0), nextChoice(0) {};
+
+		std::vector<Run> runs;
+		size_t next;					// Run holding the next acquisition
+		unsigned long used;				// Acquisitions already made of that run
+		unsigned long acquired;
+		std::vector<unsigned int> choices;
+		size_t nextChoice;
+	};
+
+	// A core running a process, for the dispatch'th time of that process
+	struct Decision {
+		Decision(unsigned int decisionProcess, unsigned int decisionDispatch) : process(decisionProcess), dispatch(decisionDispatch) {};
+
+		unsigned int process;
+		unsigned int dispatch;
+	};
+
+	// Not copyable
+	Trace(const Trace&);
+	Trace& operator=(const Trace&);
+
+	// Private functions
+	void Append(unsigned int channel);
+	void AwaitTurn(unsigned int channel);
+	void TakeTurn(unsigned int channel);
+	void Diverge(std::string where);
+	std::string ChannelName(unsigned int channel) const;
+	void Write() throw(std::logic_error);
+	void Read() throw(std::logic_error);
+	static uint64_t ReadNumber(const std::string &in, size_t &pos) throw(std::logic_error);
+	static long double Now();
+
+	// A replay which makes no progress for this long (s) has diverged from the trace
+	static const int stallLimit = 10;
+
+	Mode mode;
+	std::string tracePath;
+	unsigned int cpuCount;
+	std::vector<Stream> streams;					// One per traced lock
+	std::vector<std::vector<Decision> > decisions;	// One list per core, in dispatch order
+	std::vector<size_t> nextDecision;				// While replaying, each core's next decision
+	size_t bytes;									// Size of the trace file
+	std::string summary;
+
+	// Replay turns
+	pthread_mutex_t turnMutex;						// Guards the replay positions of the streams, and the divergence
+	pthread_cond_t turnTaken;
+	std::atomic<bool> diverged;
+	std::string divergence;							// Where the replay left the trace
+	std::atomic<long> progress;						// When (s) a replaying thread last took a turn or a core dispatched
+
+	static thread_local uint32_t thread;			// Name of the calling thread
+};
+
+#endif	// !TRACE_H
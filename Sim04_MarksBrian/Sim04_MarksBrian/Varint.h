@@ -0,0 +1,71 @@
+/**
+*	@file Varint.h
+*	@author Brian Marks
+*	@version 1.0
+*	@details Variable-length integers, as written to the trace and binary event log files: seven bits per byte, low
+*	bits first, the high bit set on every byte but the last. Reading reports a damaged number rather than throwing,
+*	so each file can name itself in its own error.
+*	@date Monday, April 30, 2018
+*/
+
+//
+// Compiler Guards ////////////////////////
+//
+#ifndef VARINT_H
+#define VARINT_H
+
+//
+// Header Files ///////////////////////////
+//
+#include <string>
+#include <stdint.h>
+
+//
+// Class Declaration ///////////////////////////
+//
+class Varint {
+public:
+	static void Write(std::string &out, uint64_t value);
+	static bool Read(const std::string &in, size_t &pos, uint64_t &value);
+};
+
+//
+// Class Function Definitions /////////////////
+//
+
+/**	Write
+*	\n Appends a number as a variable-length integer.
+*	@param out is the text being written
+*	@param value is the number
+*/
+inline void Varint::Write(std::string &out, uint64_t value) {
+	while (value >= 0x80) {
+		out.push_back((char)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((char)value);
+}
+
+/**	Read
+*	\n Reads a variable-length integer written by Write.
+*	@param in is the text being read
+*	@param pos is the position of the number, moved past it
+*	@param value receives the number
+*	@return false if the text ends within the number, or the number has more than 64 bits
+*/
+inline bool Varint::Read(const std::string &in, size_t &pos, uint64_t &value) {
+	value = 0;
+	for (unsigned int shift = 0; shift < 64; shift += 7) {
+		if (pos >= in.size()) {
+			return false;
+		}
+		unsigned char byte = in[pos++];
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+#endif	// !VARINT_H
@@ -0,0 +1,88 @@
+/**
+*	@file WaitHistogram.cpp
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class implementation for a histogram of the time spent waiting on a resource.
+*	@date Friday, April 27, 2018
+*/
+
+//
+// Header Files ///////////////////////////
+//
+#include "WaitHistogram.h"
+
+//
+// Class Function Definitions /////////////////
+//
+
+/**	Constructor
+*	\n Creates an empty histogram.
+*/
+WaitHistogram::WaitHistogram() {
+	Clear();
+}
+
+/**	Record
+*	\n Adds one wait to the histogram. Safe to call from any thread.
+*	@param microSeconds is the length of the wait
+*/
+void WaitHistogram::Record(long double microSeconds) {
+	unsigned long long wait = (microSeconds > 0 ? (unsigned long long)microSeconds : 0);
+	unsigned int bucket = 0;
+
+	while (bucket < BUCKETS - 1 && (wait >> bucket) != 0) {
+		bucket++;
+	}
+	buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+	totalWait.fetch_add(wait, std::memory_order_relaxed);
+
+	unsigned long long longest = maxWait.load(std::memory_order_relaxed);
+	while (wait > longest && !maxWait.compare_exchange_weak(longest, wait, std::memory_order_relaxed));
+}
+
+/**	Clear
+*	\n Empties the histogram. Must not race with Record.
+*/
+void WaitHistogram::Clear() {
+	for (unsigned int i = 0; i < BUCKETS; i++) {
+		buckets[i] = 0;
+	}
+	totalWait = 0;
+	maxWait = 0;
+}
+
+/**	Get Count
+*	\n Getter function for the number of waits recorded.
+*	@return the number of waits recorded
+*/
+unsigned long WaitHistogram::GetCount() const {
+	unsigned long count = 0;
+	for (unsigned int i = 0; i < BUCKETS; i++) {
+		count += buckets[i].load(std::memory_order_relaxed);
+	}
+	return count;
+}
+
+/**	To String
+*	\n Formats the histogram for the log: the number of waits, their mean and maximum, then each non-empty bucket
+*	by its upper bound, e.g. "3 waits, mean 40us, max 97us; <1us 1, <128us 2".
+*	@return the histogram as a string
+*/
+std::string WaitHistogram::ToString() const {
+	std::ostringstream out;
+	unsigned long count = GetCount();
+
+	out << count << " waits, mean " << (count > 0 ? totalWait.load() / count : 0) << "us, max " << maxWait.load() << "us";
+	if (count > 0) {
+		out << ";";
+		bool first = true;
+		for (unsigned int i = 0; i < BUCKETS; i++) {
+			unsigned long n = buckets[i].load(std::memory_order_relaxed);
+			if (n > 0) {
+				out << (first ? " <" : ", <") << (1ULL << i) << "us " << n;
+				first = false;
+			}
+		}
+	}
+	return out.str();
+}
@@ -0,0 +1,51 @@
+/**
+*	@file WaitHistogram.h
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class declaration for a histogram of the time spent waiting on a resource. Buckets are powers of 2
+*	microseconds, so a handful of buckets covers waits from under a microsecond to hours.
+*	@date Friday, April 27, 2018
+*/
+
+//
+// Compiler Guards ////////////////////////
+//
+#ifndef WAITHISTOGRAM_H
+#define WAITHISTOGRAM_H
+
+//
+// Header Files ///////////////////////////
+//
+#include <atomic>
+#include <string>
+#include <sstream>
+
+//
+// Class Declaration ///////////////////////////
+//
+class WaitHistogram {
+public:
+	// Constructor
+	WaitHistogram();
+
+	// Recording functions
+	void Record(long double microSeconds);
+	void Clear();
+
+	// Accessors
+	unsigned long GetCount() const;
+	std::string ToString() const;
+
+private:
+	static const unsigned int BUCKETS = 40;
+
+	// Not copyable
+	WaitHistogram(const WaitHistogram&);
+	WaitHistogram& operator=(const WaitHistogram&);
+
+	std::atomic<unsigned long> buckets[BUCKETS];	// Bucket 0 holds waits under 1us; bucket k holds [2^(k-1), 2^k) us
+	std::atomic<unsigned long long> totalWait;		// Sum of all waits (us)
+	std::atomic<unsigned long long> maxWait;		// Longest wait (us)
+};
+
+#endif	// !WAITHISTOGRAM_H
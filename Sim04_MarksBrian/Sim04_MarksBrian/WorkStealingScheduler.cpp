@@ -0,0 +1,296 @@
+/**
+*	@file WorkStealingScheduler.cpp
+*	@author Brian Marks
+*	@version 1.1
+*	@details Class implementation for a real-time multi-core scheduler with per-core run queues and work stealing.
+*	@note 1.1 update records each core's dispatches, and replays them in place of the run queues
+*	@date Thursday, April 26, 2018
+*/
+
+//
+// Header Files ///////////////////////////
+//
+#include "WorkStealingScheduler.h"
+
+//
+// Class Function Definitions /////////////////
+//
+
+/**	Constructor
+*	\n Creates a scheduler with a run queue for each core.
+*	@param processes is the set of processes to run, passed by reference
+*	@param rm is the resource manager owning the devices, passed by reference
+*	@param coreCount is the number of simulated cores (at least 1)
+*	@param coreAffinity is true to return processes woken from I/O to the core which last ran them
+*/
+WorkStealingScheduler::WorkStealingScheduler(std::vector<ProcessControlBlock> &processes, ResourceManager &rm,
+	unsigned int coreCount, bool coreAffinity) : processQueue(processes), resourceManager(rm), dispatches(processes.size()), exited(0), failed(false) {
+	for (unsigned int i = 0; i < (coreCount > 0 ? coreCount : 1); i++) {
+		Core* core = new Core();
+		core->index = i;
+		core->scheduler = this;
+		cores.push_back(core);
+	}
+	affinity = coreAffinity;
+	lastCore.assign(processes.size(), 0);
+	pthread_mutex_init(&failureMutex, NULL);
+	elapsed = 0;
+}
+
+/**	Destructor
+*	\n Releases the cores.
+*/
+WorkStealingScheduler::~WorkStealingScheduler() {
+	for (unsigned int i = 0; i < cores.size(); i++) {
+		delete cores[i];
+	}
+}
+
+/**	Run
+*	\n Runs every process to completion in real time. The schedule is dealt round robin across the cores; each core
+*	takes its own processes oldest first, so the configured schedule order is kept on each core.
+*	@param schedule is the order in which processes first become READY
+*	@throw a process failed on one of the cores
+*/
+void WorkStealingScheduler::run(const std::vector<unsigned int> &schedule) throw(std::logic_error) {
+	std::vector<pthread_t> threads(cores.size());
+
+	// Threads have not started, so the main thread may push for every core
+	for (unsigned int i = 0; i < schedule.size(); i++) {
+		cores[i % cores.size()]->runQueue.Push(schedule[i]);
+	}
+
+	wallClock.start();
+	for (unsigned int i = 0; i < cores.size(); i++) {
+		pthread_create(&threads[i], NULL, CoreThread, (void*)cores[i]);
+	}
+	for (unsigned int i = 0; i < cores.size(); i++) {
+		pthread_join(threads[i], NULL);
+	}
+	elapsed = wallClock.getElapsedMicroSeconds();
+	wallClock.stop();
+	resourceManager.WaitForIOThreads();
+
+	if (failed) {
+		throw std::logic_error(failure);
+	}
+}
+
+/**	Report
+*	\n Logs the utilization and steal count of every core, so load imbalance can be seen.
+*	@pre run() must have completed.
+*/
+void WorkStealingScheduler::report() {
+	for (unsigned int i = 0; i < cores.size(); i++) {
+		std::ostringstream line;
+		line << "OS: CPU " << i << " utilization " << std::fixed << std::setprecision(1)
+			<< (elapsed > 0 ? 100 * cores[i]->busyTime / elapsed : 0) << "%, " << cores[i]->steals << " steals";
+		logger.writeWithTimestamp(line.str());
+	}
+}
+
+/**	Core Thread
+*	\n A process that can be called in the creation of a thread which runs a simulated core.
+*	@param threadarg is the Core being run
+*/
+void* WorkStealingScheduler::CoreThread(void* threadarg) {
+	Core* core = (Core*)threadarg;
+	logger.setCPU(core->index);
+	Trace::SetThread(Trace::CPUThread(core->index));
+	core->scheduler->CoreLoop(*core);
+
+	return NULL;
+}
+
+/**	Core Loop
+*	\n Runs processes on a core until every process has exited or any core has failed.
+*	@param core is the core being run
+*/
+void WorkStealingScheduler::CoreLoop(Core &core) {
+	unsigned int next;
+
+	while (exited < processQueue.size() && !failed) {
+		// Anything posted after this is looked for again rather than slept through
+		unsigned long wakeCount = resourceManager.GetWakeCount();
+
+		if (FindWork(core, next)) {
+			try {
+				RunProcess(core, next);
+			}
+			catch (std::exception &e) {
+				Fail(e.what());
+			}
+		}
+		else if (resourceManager.GetMemoryWaiting() > 0 && exited + resourceManager.GetMemoryWaiting() >= processQueue.size()) {
+			// Every remaining process is waiting on memory, so none is left running to free a block or exit
+			Fail("Deadlock: every remaining process is waiting on memory held by the others.");
+		}
+		else if (trace.CheckStall(core.index)) {
+			// A replay which has left its trace would run unordered; stop it instead
+			Fail(trace.GetDivergence());
+		}
+		else {
+			// Idle until I/O completes, memory is released, or another core has work to steal or has finished
+			resourceManager.WaitForWake(wakeCount, idleTimeout);
+		}
+	}
+}
+
+/**	Find Work
+*	\n Finds the next process for a core: from its own run queue first, then from I/O completions, then by
+*	stealing the oldest process from another core's run queue.
+*	@param core is the core looking for work
+*	@param next receives the index of the process to run
+*	@return true if a process was found
+*/
+bool WorkStealingScheduler::FindWork(Core &core, unsigned int &next) {
+	// Replaying: the trace names the process, which the core waits for until it is ready to run that time
+	if (trace.Replaying()) {
+		RouteCompletions(core);
+		unsigned int dispatch;
+		if (!trace.NextDecision(core.index, next, dispatch) || next >= processQueue.size() || dispatches[next] != dispatch) {
+			return false;
+		}
+		ProcessControlBlock::State state = processQueue[next].getState();
+		if (state != ProcessControlBlock::START && state != ProcessControlBlock::READY) {
+			return false;
+		}
+		trace.TakeDecision(core.index);
+		return true;
+	}
+
+	// Take processes handed over by other cores
+	pthread_mutex_lock(&core.inboxMutex);
+	for (unsigned int i = 0; i < core.inbox.size(); i++) {
+		core.runQueue.Push(core.inbox[i]);
+	}
+	core.inbox.clear();
+	pthread_mutex_unlock(&core.inboxMutex);
+
+	// Own run queue, oldest first; a failed attempt means a thief took the item, so try again
+	while (!core.runQueue.Empty()) {
+		if (core.runQueue.Steal(next)) {
+			return true;
+		}
+	}
+
+	// Processes woken by I/O
+	RouteCompletions(core);
+	while (!core.runQueue.Empty()) {
+		if (core.runQueue.Steal(next)) {
+			return true;
+		}
+	}
+
+	// Steal from the other cores, starting with the next one
+	for (unsigned int i = 1; i < cores.size(); i++) {
+		Core &victim = *cores[(core.index + i) % cores.size()];
+		if (victim.runQueue.Steal(next)) {
+			core.steals++;
+			if (logger.isEnabled(Log::DEBUG)) {
+				logger.writeWithTimestamp("OS: CPU " + std::to_string(core.index) + " stole process " + std::to_string(next+1)
+					+ " from CPU " + std::to_string(victim.index), Log::DEBUG);
+			}
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**	Route Completions
+*	\n Makes processes whose I/O has completed READY, placing each on the core which last ran it when affinity is
+*	enabled, otherwise on the core which collected the completion.
+*	@param core is the core collecting completions
+*/
+void WorkStealingScheduler::RouteCompletions(Core &core) {
+	std::vector<int> completions;
+	resourceManager.TakeCompletions(completions);
+
+	for (unsigned int i = 0; i < completions.size(); i++) {
+		unsigned int pid = completions[i];
+		processQueue[pid].changeState(ProcessControlBlock::READY);
+
+		if (trace.Replaying()) {
+			continue;				// The trace says which core runs it
+		}
+		if (!affinity || lastCore[pid] == core.index) {
+			core.runQueue.Push(pid);
+		}
+		else {
+			Core &target = *cores[lastCore[pid]];
+			pthread_mutex_lock(&target.inboxMutex);
+			target.inbox.push_back(pid);
+			pthread_mutex_unlock(&target.inboxMutex);
+		}
+	}
+
+	// Idle cores may take what this core cannot run yet
+	if (!completions.empty() && cores.size() > 1) {
+		resourceManager.WakeIdle();
+	}
+}
+
+/**	Run Process
+*	\n Runs a process on a core until it blocks on I/O or exits.
+*	@param core is the core running the process
+*	@param next is the index of the process to run
+*/
+void WorkStealingScheduler::RunProcess(Core &core, unsigned int next) {
+	lastCore[next] = core.index;
+
+	if (processQueue[next].getState() == ProcessControlBlock::START) {
+		// Log: (ts) OS: Preparing Process (i)
+		logger.writeProcessEvent(EventLog::PREPARING, next);
+		processQueue[next].changeState(ProcessControlBlock::READY);
+
+		// Log: (ts) OS: Starting Process (i)
+		logger.writeProcessEvent(EventLog::STARTING, next, OnCPU(core));
+	}
+	else {
+		// Log: (ts) OS: Resuming Process (i)
+		logger.writeProcessEvent(EventLog::RESUMING, next, OnCPU(core));
+	}
+	processQueue[next].changeState(ProcessControlBlock::RUNNING);
+	trace.Decide(core.index, next, dispatches[next]++);
+
+	// Run Process until it blocks on I/O or finishes
+	Timer busy;
+	busy.start();
+	ProcessControlBlock::State processState = processQueue[next].run(resourceManager);
+	core.busyTime += busy.getElapsedMicroSeconds();
+
+	if (processState == ProcessControlBlock::EXIT) {
+		// Log: (ts) OS: Removing Process (i)
+		logger.writeProcessEvent(EventLog::REMOVING, next);
+		exited++;
+		resourceManager.WakeIdle();
+	}
+	else if (processState != ProcessControlBlock::WAITING) {
+		throw std::logic_error("Process has failed to execute successfully.");
+	}
+}
+
+/**	Fail
+*	\n Stops the run on every core, keeping the first reason given.
+*	@param reason is the error the run stops with
+*/
+void WorkStealingScheduler::Fail(const std::string &reason) {
+	pthread_mutex_lock(&failureMutex);
+	if (!failed) {
+		failure = reason;
+		failed = true;
+	}
+	pthread_mutex_unlock(&failureMutex);
+	resourceManager.WakeIdle();
+}
+
+/**	On CPU
+*	\n Names the core a process is dispatched to, for log lines. None is named on a single core, so single-CPU
+*	logs are unchanged.
+*	@param core is the core running the process
+*	@return the CPU to name in a dispatch log line, or -1
+*/
+int WorkStealingScheduler::OnCPU(const Core &core) const {
+	return cores.size() > 1 ? (int)core.index : -1;
+}
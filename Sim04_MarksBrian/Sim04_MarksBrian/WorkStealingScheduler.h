@@ -0,0 +1,94 @@
+/**
+*	@file WorkStealingScheduler.h
+*	@author Brian Marks
+*	@version 1.1
+*	@details Class declaration for a real-time multi-core scheduler. Each simulated core runs on its own thread with
+*	its own run queue; a core with nothing to run steals READY processes from the other cores.
+*	@note 1.1 update records each core's dispatches, and replays them in place of the run queues
+*	@date Thursday, April 26, 2018
+*/
+
+//
+// Compiler Guards ////////////////////////
+//
+#ifndef WORKSTEALINGSCHEDULER_H
+#define WORKSTEALINGSCHEDULER_H
+
+//
+// Header Files ///////////////////////////
+//
+#include <atomic>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <pthread.h>
+#include <unistd.h>
+#include "ChaseLevDeque.h"
+#include "Log.h"
+#include "ProcessControlBlock.h"
+#include "ResourceManager.h"
+#include "Timer.h"
+#include "Trace.h"
+
+extern Log logger;
+extern Trace trace;
+
+//
+// Class Declaration ///////////////////////////
+//
+class WorkStealingScheduler {
+public:
+	// Constructor/Destructor
+	WorkStealingScheduler(std::vector<ProcessControlBlock> &processes, ResourceManager &rm, unsigned int coreCount, bool coreAffinity);
+	~WorkStealingScheduler();
+
+	// Simulator functions
+	void run(const std::vector<unsigned int> &schedule) throw(std::logic_error);
+	void report();
+
+private:
+	// A simulated core and its run queue
+	struct Core {
+		Core() : steals(0), busyTime(0) { pthread_mutex_init(&inboxMutex, NULL); };
+
+		unsigned int index;
+		WorkStealingScheduler* scheduler;
+		ChaseLevDeque<unsigned int> runQueue;
+		pthread_mutex_t inboxMutex;				// Guards inbox
+		std::vector<unsigned int> inbox;		// Processes handed to this core by others; only the owner may push to runQueue
+		unsigned long steals;
+		long double busyTime;					// Time (us) spent running processes
+	};
+
+	// Private functions
+	static void* CoreThread(void* threadarg);
+	void CoreLoop(Core &core);
+	bool FindWork(Core &core, unsigned int &next);
+	void RouteCompletions(Core &core);
+	void RunProcess(Core &core, unsigned int next);
+	int OnCPU(const Core &core) const;
+	void Fail(const std::string &reason);
+
+	// An idle core rechecks at least this often (us), to notice a replay which has stalled
+	static const long idleTimeout = 100000;
+
+	// Processes and devices being scheduled
+	std::vector<ProcessControlBlock> &processQueue;
+	ResourceManager &resourceManager;
+
+	// Cores
+	std::vector<Core*> cores;
+	bool affinity;								// Return woken processes to the core which last ran them
+	std::vector<unsigned int> lastCore;			// Written before a process starts I/O, read after its completion
+	std::vector<std::atomic<unsigned int> > dispatches;	// Times each process has been run, for tracing
+
+	// Run status
+	std::atomic<unsigned int> exited;
+	std::atomic<bool> failed;
+	pthread_mutex_t failureMutex;
+	std::string failure;
+	Timer wallClock;
+	long double elapsed;						// Wall time (us) of the run
+};
+
+#endif	// !WORKSTEALINGSCHEDULER_H
@@ -0,0 +1,422 @@
+/**
+*	@file WorkloadGenerator.cpp
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class implementation for a synthetic meta-data workload generator.
+*	@date Monday, April 30, 2018
+*/
+
+//
+// Header Files ///////////////////////////
+//
+#include "WorkloadGenerator.h"
+
+// Names of the generated devices, indexed by Device
+static const char* deviceNames[] = { "hard drive", "keyboard", "scanner", "monitor", "projector" };
+
+// Size of the output buffer (bytes)
+static const size_t bufferSize = 1 << 20;
+
+//
+// Class Function Definitions /////////////////
+//
+
+/**	Constructor
+*	\n Creates a generator for ten processes of ten operations each, with a mix of processor, I/O and memory operations,
+*	uniform cycle counts from 1 to 10, and every device equally likely.
+*/
+WorkloadGenerator::WorkloadGenerator() {
+	SetProcesses(10, 10);
+	SetMix("4:2:2:2");
+	SetCycles("uniform:1:10");
+	SetDevices("hard drive=1,keyboard=1,scanner=1,monitor=1,projector=1");
+	SetAffinity(0);
+	SetCylinders(0);
+	SetFreeing(false);
+	SetSeed(1);
+	output = NULL;
+	used = 0;
+}
+
+/**	Set Processes
+*	\n Sets the size of the workload.
+*	@param processCount is the number of applications
+*	@param operationsPerProcess is the number of operations in each application, between A{begin} and A{finish}
+*/
+void WorkloadGenerator::SetProcesses(unsigned long processCount, unsigned int operationsPerProcess) {
+	processes = processCount;
+	operations = operationsPerProcess;
+}
+
+/**	Set Mix
+*	\n Sets the relative weights of processor, input, output and memory operations.
+*	@param mix is four non-negative weights separated by ':', in P:I:O:M order (e.g. "4:2:2:2")
+*	@throw the mix is malformed, or every weight is zero
+*/
+void WorkloadGenerator::SetMix(std::string mix) throw(std::logic_error) {
+	std::istringstream in(mix);
+	std::vector<double> weights(CODE_COUNT);
+
+	for (unsigned int i = 0; i < CODE_COUNT; i++) {
+		char separator = ':';
+		if ((i > 0 && !(in >> separator)) || separator != ':' || !(in >> weights[i]) || weights[i] < 0) {
+			throw std::logic_error("Operation mix must be four weights, P:I:O:M.");
+		}
+	}
+	if (!(in >> std::ws).eof()) {
+		throw std::logic_error("Operation mix must be four weights, P:I:O:M.");
+	}
+
+	codeTable.Build(weights);
+	codeWeights = weights;
+}
+
+/**	Set Cycles
+*	\n Sets the distribution of operation cycle counts.
+*	@param spec is "uniform:low:high", "zipf:exponent:low:high", or "pareto:alpha:low:high"
+*	@throw the specification is malformed
+*/
+void WorkloadGenerator::SetCycles(std::string spec) throw(std::logic_error) {
+	std::string name = spec.substr(0, spec.find(':'));
+	std::istringstream in(spec.find(':') == std::string::npos ? "" : spec.substr(spec.find(':') + 1));
+	char separator = ':';
+	double parameter = 0;
+	long first = 0;
+	long last = 0;
+
+	if (name == "uniform") {
+		distribution = UNIFORM;
+	}
+	else if (name == "zipf") {
+		distribution = ZIPF;
+	}
+	else if (name == "pareto") {
+		distribution = PARETO;
+	}
+	else {
+		throw std::logic_error("Cycle distribution must be uniform, zipf, or pareto.");
+	}
+
+	if ((distribution != UNIFORM && (!(in >> parameter >> separator) || separator != ':' || parameter <= 0))
+		|| !(in >> first >> separator >> last) || separator != ':' || first < 0 || last < first || !(in >> std::ws).eof()) {
+		throw std::logic_error("Cycle distribution must be uniform:low:high, zipf:exponent:low:high, or pareto:alpha:low:high.");
+	}
+	if (distribution == PARETO && first == 0) {
+		throw std::logic_error("Pareto cycle counts must start at 1 or more.");
+	}
+
+	shape = parameter;
+	low = first;
+	high = last;
+
+	// Zipf counts are drawn from a table of the weight of every count in range
+	if (distribution == ZIPF) {
+		std::vector<double> weights(high - low + 1);
+		for (unsigned int k = 0; k < weights.size(); k++) {
+			weights[k] = 1.0 / std::pow(k + 1.0, shape);
+		}
+		zipfTable.Build(weights);
+	}
+}
+
+/**	Set Devices
+*	\n Sets the relative weights of the I/O devices. Input operations use the hard drive, keyboard or scanner; output
+*	operations use the hard drive, monitor or projector. Devices not named are never used.
+*	@param weights is a list of device=weight pairs separated by ',' (e.g. "hard drive=3,monitor=1")
+*	@throw a device is unknown or a weight is malformed
+*/
+void WorkloadGenerator::SetDevices(std::string weights) throw(std::logic_error) {
+	std::istringstream in(weights);
+	std::string pair;
+
+	deviceWeights.assign(DEVICE_COUNT, 0);
+	while (std::getline(in, pair, ',')) {
+		std::string::size_type split = pair.find('=');
+		unsigned int device = 0;
+		while (device < DEVICE_COUNT && (split == std::string::npos || pair.substr(0, split) != deviceNames[device])) {
+			device++;
+		}
+		char* end = NULL;
+		double weight = device < DEVICE_COUNT ? strtod(pair.c_str() + split + 1, &end) : -1;
+		if (device == DEVICE_COUNT || end == pair.c_str() + split + 1 || *end != '\0' || weight < 0) {
+			throw std::logic_error("Device weights must be device=weight pairs naming hard drive, keyboard, scanner, monitor, or projector.");
+		}
+		deviceWeights[device] = weight;
+	}
+
+	std::vector<double> input(deviceWeights);
+	std::vector<double> output(deviceWeights);
+	input[MONITOR] = input[PROJECTOR] = 0;
+	output[KEYBOARD] = output[SCANNER] = 0;
+	inputTable = AliasTable();
+	outputTable = AliasTable();
+	if (input[HARD_DRIVE] + input[KEYBOARD] + input[SCANNER] > 0) {
+		inputTable.Build(input);
+	}
+	if (output[HARD_DRIVE] + output[MONITOR] + output[PROJECTOR] > 0) {
+		outputTable.Build(output);
+	}
+}
+
+/**	Set Affinity
+*	\n Sets how strongly each process sticks to its home devices. Every process draws one home input device and one
+*	home output device; each of its I/O operations uses the home device with this probability, and otherwise draws a
+*	device by weight.
+*	@param probability is between 0 (no affinity) and 1 (every I/O on the home devices)
+*	@throw the probability is out of range
+*/
+void WorkloadGenerator::SetAffinity(double probability) throw(std::logic_error) {
+	if (probability < 0 || probability > 1) {
+		throw std::logic_error("Device affinity must be between 0 and 1.");
+	}
+	affinity = probability;
+}
+
+/**	Set Cylinders
+*	\n Sets whether hard drive operations name a cylinder, as {hard drive:cylinder}.
+*	@param cylinderCount is the number of cylinders to choose from, or 0 to name none
+*/
+void WorkloadGenerator::SetCylinders(int cylinderCount) {
+	cylinders = cylinderCount;
+}
+
+/**	Set Freeing
+*	\n Sets whether memory operations may free earlier allocations with M{free}.
+*	@param freeMemory is true to generate M{free} operations
+*/
+void WorkloadGenerator::SetFreeing(bool freeMemory) {
+	freeing = freeMemory;
+}
+
+/**	Set Seed
+*	\n Seeds the random number generator; the same seed and settings always give the same workload.
+*	@param seed is the seed
+*/
+void WorkloadGenerator::SetSeed(uint64_t seed) {
+	state = seed;
+}
+
+/**	Write
+*	\n Writes the whole workload as a meta-data file, one application per line.
+*	@param out is the open file written to
+*	@throw an I/O operation has no device to use, or the file cannot be written
+*/
+void WorkloadGenerator::Write(FILE* out) throw(std::logic_error) {
+	if ((codeWeights[INPUT] > 0 && inputTable.alias.empty()) || (codeWeights[OUTPUT] > 0 && outputTable.alias.empty())) {
+		throw std::logic_error("The operation mix includes I/O with no device weighted to serve it.");
+	}
+
+	output = out;
+	buffer.resize(bufferSize + 256);
+	used = 0;
+
+	Append("Start Program Meta-Data Code:\nS{begin}0;\n");
+	for (unsigned long i = 0; i < processes; i++) {
+		WriteProcess();
+	}
+	Append("S{finish}0.\nEnd Program Meta-Data Code.\n");
+	Flush();
+}
+
+/**	Build
+*	\n Builds an alias table for drawing index i with probability weights[i] / sum(weights), in O(1) per draw.
+*	@param weights are the non-negative weights of each index
+*	@throw every weight is zero
+*/
+void WorkloadGenerator::AliasTable::Build(const std::vector<double> &weights) throw(std::logic_error) {
+	double total = 0;
+	for (unsigned int i = 0; i < weights.size(); i++) {
+		total += weights[i];
+	}
+	if (total <= 0) {
+		throw std::logic_error("At least one weight must be positive.");
+	}
+
+	// Scale each weight so the mean is 1, then pair each under-full slot with an over-full one
+	std::vector<double> scaled(weights.size());
+	std::vector<unsigned int> small;
+	std::vector<unsigned int> large;
+	for (unsigned int i = 0; i < weights.size(); i++) {
+		scaled[i] = weights[i] * weights.size() / total;
+		(scaled[i] < 1 ? small : large).push_back(i);
+	}
+
+	probability.assign(weights.size(), 1);
+	alias.resize(weights.size());
+	for (unsigned int i = 0; i < alias.size(); i++) {
+		alias[i] = i;
+	}
+	while (!small.empty() && !large.empty()) {
+		unsigned int under = small.back();
+		unsigned int over = large.back();
+		small.pop_back();
+		probability[under] = scaled[under];
+		alias[under] = over;
+		scaled[over] -= 1 - scaled[under];
+		if (scaled[over] < 1) {
+			large.pop_back();
+			small.push_back(over);
+		}
+	}
+}
+
+/**	Next Random
+*	\n Advances the random number generator.
+*	@return 64 random bits
+*/
+uint64_t WorkloadGenerator::NextRandom() {
+	uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+/**	Next Unit
+*	\n Draws a number uniformly from [0, 1).
+*	@return the number drawn
+*/
+double WorkloadGenerator::NextUnit() {
+	return (NextRandom() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**	Draw
+*	\n Draws an index from an alias table, using the high half of one random number to pick the slot and the low half
+*	to choose between the slot and its alias.
+*	@param table is the table drawn from
+*	@return the index drawn
+*/
+unsigned int WorkloadGenerator::Draw(const AliasTable &table) {
+	uint64_t bits = NextRandom();
+	unsigned int slot = (unsigned int)(((bits >> 32) * table.probability.size()) >> 32);
+	return (bits & 0xFFFFFFFFULL) * (1.0 / 4294967296.0) < table.probability[slot] ? slot : table.alias[slot];
+}
+
+/**	Draw Cycles
+*	\n Draws the cycle count of an operation from the configured distribution.
+*	@return the cycle count
+*/
+unsigned int WorkloadGenerator::DrawCycles() {
+	switch (distribution) {
+		case ZIPF:
+			return low + Draw(zipfTable);
+
+		case PARETO: {
+			double cycles = low / std::pow(1.0 - NextUnit(), 1.0 / shape);
+			return cycles < high ? (unsigned int)cycles : high;
+		}
+
+		default:
+			return low + (unsigned int)(NextUnit() * (high - low + 1));
+	}
+}
+
+/**	Draw Device
+*	\n Chooses the device of an I/O operation, keeping to the process' home device with the affinity probability.
+*	@param input is true for an input operation, false for output
+*	@param home is the process' home device for the direction
+*	@return the device
+*/
+unsigned int WorkloadGenerator::DrawDevice(bool input, unsigned int home) {
+	if (affinity > 0 && NextUnit() < affinity) {
+		return home;
+	}
+	return Draw(input ? inputTable : outputTable);
+}
+
+/**	Write Process
+*	\n Appends one application, A{begin} to A{finish}, to the output buffer.
+*/
+void WorkloadGenerator::WriteProcess() {
+	unsigned int homeInput = inputTable.alias.empty() ? 0 : Draw(inputTable);
+	unsigned int homeOutput = outputTable.alias.empty() ? 0 : Draw(outputTable);
+	unsigned int held = 0;
+
+	Append(" A{begin}0;");
+	for (unsigned int i = 0; i < operations; i++) {
+		unsigned int code = Draw(codeTable);
+		unsigned long cycles = 1;
+
+		switch (code) {
+			case PROCESSOR:
+				Append(" P{run}");
+				cycles = DrawCycles();
+				break;
+
+			case INPUT:
+			case OUTPUT: {
+				bool input = (code == INPUT);
+				unsigned int device = DrawDevice(input, input ? homeInput : homeOutput);
+				Append(input ? " I{" : " O{");
+				Append(deviceNames[device]);
+				if (device == HARD_DRIVE && cylinders > 0) {
+					Append(":");
+					Append((unsigned long)(NextRandom() % cylinders));
+				}
+				Append("}");
+				cycles = DrawCycles();
+				break;
+			}
+
+			default:
+				// Memory: free an earlier allocation, allocate, or block
+				if (freeing && held > 0 && NextUnit() < 1.0 / 3) {
+					Append(" M{free}");
+					held--;
+				}
+				else if (NextUnit() < 0.5) {
+					Append(" M{allocate}");
+					held++;
+				}
+				else {
+					Append(" M{block}");
+					cycles = DrawCycles();
+				}
+		}
+		Append(cycles);
+		Append(";");
+
+		// Every operation fits in the space kept past bufferSize
+		if (used >= bufferSize) {
+			Flush();
+		}
+	}
+	Append(" A{finish}0;\n");
+}
+
+/**	Append
+*	\n Appends text to the output buffer.
+*	@param text is the text
+*/
+void WorkloadGenerator::Append(const char* text) {
+	while (*text) {
+		buffer[used++] = *text++;
+	}
+}
+
+/**	Append
+*	\n Appends a number, in decimal, to the output buffer.
+*	@param value is the number
+*/
+void WorkloadGenerator::Append(unsigned long value) {
+	char digits[24];
+	int count = 0;
+
+	do {
+		digits[count++] = '0' + value % 10;
+		value /= 10;
+	} while (value > 0);
+	while (count > 0) {
+		buffer[used++] = digits[--count];
+	}
+}
+
+/**	Flush
+*	\n Writes the output buffer to the file and empties it.
+*	@throw the file cannot be written
+*/
+void WorkloadGenerator::Flush() throw(std::logic_error) {
+	if (used > 0 && fwrite(&buffer[0], 1, used, output) != used) {
+		throw std::logic_error("Workload could not be written.");
+	}
+	used = 0;
+}
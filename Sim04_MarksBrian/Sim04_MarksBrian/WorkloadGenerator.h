@@ -0,0 +1,109 @@
+/**
+*	@file WorkloadGenerator.h
+*	@author Brian Marks
+*	@version 1.0
+*	@details Class declaration for a synthetic workload generator which writes meta-data (.mdf) files for scale testing.
+*	The number of processes, the mix of operation codes, the distribution of cycle counts and the devices used for I/O
+*	are configurable, and a seed makes every workload reproducible.
+*	@date Monday, April 30, 2018
+*/
+
+//
+// Compiler Guards ////////////////////////
+//
+#ifndef WORKLOADGENERATOR_H
+#define WORKLOADGENERATOR_H
+
+//
+// Header Files ///////////////////////////
+//
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <stdexcept>
+#include <stdint.h>
+
+//
+// Class Declaration ///////////////////////////
+//
+class WorkloadGenerator {
+public:
+	// Distributions of operation cycle counts
+	enum Distribution {
+		UNIFORM,		// Every count in [low, high] equally likely
+		ZIPF,			// Count k in [low, high] with weight 1 / (k - low + 1)^exponent
+		PARETO			// Heavy-tailed: low / U^(1 / alpha), capped at high
+	};
+
+	// Constructor
+	WorkloadGenerator();
+
+	// Initialization functions
+	void SetProcesses(unsigned long processCount, unsigned int operationsPerProcess);
+	void SetMix(std::string mix) throw(std::logic_error);
+	void SetCycles(std::string spec) throw(std::logic_error);
+	void SetDevices(std::string weights) throw(std::logic_error);
+	void SetAffinity(double probability) throw(std::logic_error);
+	void SetCylinders(int cylinderCount);
+	void SetFreeing(bool freeMemory);
+	void SetSeed(uint64_t seed);
+
+	// Generator functions
+	void Write(FILE* out) throw(std::logic_error);
+
+private:
+	// Meta-data codes which may be generated
+	enum OperationCode { PROCESSOR, INPUT, OUTPUT, MEMORY, CODE_COUNT };
+
+	// I/O devices which may be generated
+	enum Device { HARD_DRIVE, KEYBOARD, SCANNER, MONITOR, PROJECTOR, DEVICE_COUNT };
+
+	// Table for drawing from a discrete distribution in O(1) (Vose's alias method)
+	struct AliasTable {
+		void Build(const std::vector<double> &weights) throw(std::logic_error);
+
+		std::vector<double> probability;
+		std::vector<unsigned int> alias;
+	};
+
+	// Private functions
+	uint64_t NextRandom();
+	double NextUnit();
+	unsigned int Draw(const AliasTable &table);
+	unsigned int DrawCycles();
+	unsigned int DrawDevice(bool input, unsigned int home);
+	void WriteProcess();
+	void Append(const char* text);
+	void Append(unsigned long value);
+	void Flush() throw(std::logic_error);
+
+	// Workload shape
+	unsigned long processes;
+	unsigned int operations;
+	std::vector<double> codeWeights;
+	AliasTable codeTable;
+	Distribution distribution;
+	double shape;							// Zipf exponent or Pareto alpha
+	unsigned int low;
+	unsigned int high;
+	AliasTable zipfTable;
+	std::vector<double> deviceWeights;
+	AliasTable inputTable;
+	AliasTable outputTable;
+	double affinity;						// Probability that an I/O operation uses its process' home device
+	int cylinders;							// Hard drive operations name a cylinder in [0, cylinders) if positive
+	bool freeing;							// Memory operations may free earlier allocations
+
+	// Random number generator state (splitmix64)
+	uint64_t state;
+
+	// Output buffer, written out in large blocks
+	FILE* output;
+	std::vector<char> buffer;
+	size_t used;
+};
+
+#endif	// !WORKLOADGENERATOR_H